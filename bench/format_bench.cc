@@ -0,0 +1,185 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "props_formatter.h"
+#include "props_json_formatter.h"
+#include "props_msgpack_formatter.h"
+
+/**
+ * Namespace for constants
+ */
+namespace format_bench {
+    static const size_t DEFAULT_NUM_MATCHES = 1000000;
+    static const size_t MATCHES_PER_FILE = 1000;
+    static const int NUM_RUNS = 3;
+}
+
+/**
+ * A stream buffer discarding the output and
+ * just counting the number of bytes written.
+ */
+class CountingBuffer : public std::streambuf {
+
+public:
+
+    /**
+     * Retrieves the number of bytes written.
+     *
+     * @return the number of bytes written
+     */
+    size_t getSize() const {
+        return size_;
+    }
+
+protected:
+
+    std::streamsize xsputn(const char* /*s*/, std::streamsize n) override {
+        size_ += static_cast<size_t>(n);
+        return n;
+    }
+
+    int_type overflow(int_type ch) override {
+        size_++;
+        return traits_type::not_eof(ch);
+    }
+
+private:
+
+    size_t size_{0};
+};
+
+// Prototypes for local functions
+void build_corpus(const size_t& numMatches, std::string& corpus, std::vector<p_search_res::Match>& matches);
+double run(const PropsFormatter& formatter, const PropsSearchOptions& searchOptions,
+           const std::vector<p_search_res::Match>& matches, size_t& size);
+
+/**
+ * Builds a synthetic properties file with one
+ * match per line.
+ *
+ * @param numMatches the number of matches
+ * @param corpus the contents of the file
+ * @param matches the matches of the file
+ */
+void build_corpus(const size_t& numMatches, std::string& corpus, std::vector<p_search_res::Match>& matches) {
+    std::vector<size_t> offsets;
+    std::vector<size_t> separators;
+    offsets.reserve(numMatches);
+    separators.reserve(numMatches);
+
+    for (size_t i = 0; i < numMatches; i++) {
+        offsets.push_back(corpus.size());
+        corpus += "app.module" + std::to_string(i % 1000) + ".\"path\"";
+        separators.push_back(corpus.size());
+        corpus += "=C:\\props\\value-" + std::to_string(i) + '\n';
+    }
+
+    matches.reserve(numMatches);
+    for (size_t i = 0; i < numMatches; i++) {
+        size_t fileOffset = offsets[(i / format_bench::MATCHES_PER_FILE) * format_bench::MATCHES_PER_FILE];
+        size_t end = ((i + 1) < numMatches) ? offsets[i + 1] : corpus.size();
+        const char* line = corpus.data() + offsets[i];
+        const char* sep = corpus.data() + separators[i];
+
+        matches.push_back(p_search_res::Match{0, offsets[i] - fileOffset,
+                                              pcrecpp::StringPiece(line, static_cast<int>(end - offsets[i] - 1)),
+                                              pcrecpp::StringPiece(line, static_cast<int>(sep - line)),
+                                              pcrecpp::StringPiece(sep + 1, static_cast<int>(corpus.data() + end - sep - 2))});
+    }
+}
+
+/**
+ * Encodes the matches (grouped in files) using
+ * the sink of the given formatter.
+ *
+ * @param formatter the formatter
+ * @param searchOptions the search options
+ * @param matches the matches
+ * @param size the number of bytes written
+ * @return the elapsed time in seconds
+ */
+double run(const PropsFormatter& formatter, const PropsSearchOptions& searchOptions,
+           const std::vector<p_search_res::Match>& matches, size_t& size) {
+    CountingBuffer buffer;
+    std::ostream out(&buffer);
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::unique_ptr<PropsResultSink> sink = formatter.createSink(searchOptions, out);
+        for (size_t i = 0; i < matches.size(); i += format_bench::MATCHES_PER_FILE) {
+            const p_search_res::Match* begin = matches.data() + i;
+            const p_search_res::Match* end = begin + std::min(format_bench::MATCHES_PER_FILE, matches.size() - i);
+            sink->add("/props/file-" + std::to_string(i / format_bench::MATCHES_PER_FILE) + ".properties",
+                      p_search_res::MatchRange(begin, end));
+        }
+        sink->finish();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    size = buffer.getSize();
+    return elapsed.count();
+}
+
+/**
+ * Compares the encoding throughput of the JSON and
+ * MessagePack formatters on a synthetic result.
+ *
+ * Usage : format_bench [number of matches]
+ *
+ * @param argc the number of arguments
+ * @param argv the list of arguments
+ * @return the exit code
+ */
+int main(int argc, char **argv) {
+    size_t numMatches = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : format_bench::DEFAULT_NUM_MATCHES;
+
+    std::string corpus;
+    std::vector<p_search_res::Match> matches;
+    build_corpus(numMatches, corpus, matches);
+
+    PropsSearchOptions searchOptions;
+    searchOptions.setKey("app.module");
+    searchOptions.setSeparator("=");
+
+    JsonPropsFormatter json;
+    MsgPackPropsFormatter msgpack;
+    const std::pair<const char*, const PropsFormatter*> formatters[] = { { "json", &json }, { "msgpack", &msgpack } };
+
+    std::cout << "Matches : " << matches.size() << std::endl;
+
+    for (const auto& formatter : formatters) {
+        double best = 0;
+        size_t size = 0;
+        for (int i = 0; i < format_bench::NUM_RUNS; i++) {
+            double elapsed = run(*formatter.second, searchOptions, matches, size);
+            best = ((i == 0) || (elapsed < best)) ? elapsed : best;
+        }
+
+        std::cout << formatter.first << std::endl
+                  << "  size       : " << size << " bytes" << std::endl
+                  << "  encode     : " << (best * 1e9 / static_cast<double>(matches.size())) << " ns/match" << std::endl
+                  << "  throughput : " << (static_cast<double>(size) / (1024 * 1024) / best) << " MiB/s" << std::endl;
+    }
+
+    return 0;
+}
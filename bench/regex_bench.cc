@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "props_regex.h"
+#include "exec_exception.h"
+
+/**
+ * Namespace for constants
+ */
+namespace regex_bench {
+    static const size_t DEFAULT_NUM_LINES = 1000000;
+    static const char* const PATTERNS[] = {
+        "^(app\\.module42\\.timeout)=(.+)",
+        "^.*?(module4.*?timeout).*?=(.+)",
+        "^(.+)=.*?(value-9.*?)$"
+    };
+}
+
+// Prototypes for local functions
+void build_corpus(const size_t& numLines, std::string& corpus, std::vector<pcrecpp::StringPiece>& lines);
+double run(const PropsRegex& regex, const std::vector<pcrecpp::StringPiece>& lines, size_t& numMatches);
+
+/**
+ * Builds a synthetic properties file with the given
+ * number of lines (including some comments).
+ *
+ * @param numLines the number of lines
+ * @param corpus the contents of the file
+ * @param lines the lines of the file
+ */
+void build_corpus(const size_t& numLines, std::string& corpus, std::vector<pcrecpp::StringPiece>& lines) {
+    std::vector<size_t> offsets;
+    offsets.reserve(numLines);
+
+    for (size_t i = 0; i < numLines; i++) {
+        offsets.push_back(corpus.size());
+        if (i % 50 == 0) {
+            corpus += "# Settings of module " + std::to_string(i % 1000);
+        } else {
+            corpus += "app.module" + std::to_string(i % 1000) + ((i % 3 == 0) ? ".timeout" : ".name")
+                      + "=value-" + std::to_string(i);
+        }
+        corpus += '\n';
+    }
+
+    lines.reserve(numLines);
+    for (size_t i = 0; i < numLines; i++) {
+        size_t end = ((i + 1) < numLines) ? offsets[i + 1] : corpus.size();
+        lines.emplace_back(corpus.data() + offsets[i], static_cast<int>(end - offsets[i] - 1));
+    }
+}
+
+/**
+ * Matches every line with the given pattern.
+ *
+ * @param regex the compiled pattern
+ * @param lines the lines to match
+ * @param numMatches the number of lines matched
+ * @return the elapsed time in nanoseconds per line
+ */
+double run(const PropsRegex& regex, const std::vector<pcrecpp::StringPiece>& lines, size_t& numMatches) {
+    pcrecpp::StringPiece key;
+    pcrecpp::StringPiece value;
+    numMatches = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& line : lines) {
+        if (regex.match(line, &key, &value)) {
+            numMatches++;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    return static_cast<double>(elapsed.count()) / static_cast<double>(lines.size());
+}
+
+/**
+ * Compares the time per line of interpreted and JIT compiled
+ * matching of search patterns on a synthetic corpus.
+ *
+ * Usage : regex_bench [number of lines]
+ *
+ * @param argc the number of arguments
+ * @param argv the list of arguments
+ * @return the exit code
+ */
+int main(int argc, char **argv) {
+    int ret_code = 0;
+    size_t numLines = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : regex_bench::DEFAULT_NUM_LINES;
+
+    std::string corpus;
+    std::vector<pcrecpp::StringPiece> lines;
+    build_corpus(numLines, corpus, lines);
+
+    std::cout << "Lines : " << lines.size() << std::endl;
+
+    try {
+        for (const char* pattern : regex_bench::PATTERNS) {
+            PropsRegex interpreted(pattern, false, false);
+            PropsRegex jit(pattern, false, true);
+
+            size_t interpretedMatches = 0;
+            size_t jitMatches = 0;
+            double interpretedTime = run(interpreted, lines, interpretedMatches);
+            double jitTime = run(jit, lines, jitMatches);
+
+            std::cout << pattern << std::endl
+                      << "  interpreted : " << interpretedTime << " ns/line (" << interpretedMatches << " matches)" << std::endl
+                      << "  jit         : " << jitTime << " ns/line (" << jitMatches << " matches)"
+                      << (jit.isJit() ? "" : " [JIT not available]") << std::endl;
+
+            if (interpretedMatches != jitMatches) {
+                std::cerr << "Mismatch in the number of matches" << std::endl;
+                ret_code = 1;
+            }
+        }
+    } catch (ExecutionException& exception) {
+        std::cerr << exception.get_info() << std::endl;
+        ret_code = 3;
+    }
+
+    return ret_code;
+}
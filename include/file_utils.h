@@ -18,6 +18,8 @@
 #define PROPS_FILE_UTILS_H
 
 #include <string>
+#include <cstdint>
+#include <vector>
 
 namespace ftl {
     static const char pathSeparator =
@@ -26,6 +28,20 @@ namespace ftl {
 #else
             '/';
 #endif
+
+    // Sources of batch entries (standard input, @file or comma separated list)
+    static const char batchStdin[] = "-";
+    static const char batchFile = '@';
+    static const char batchList = ',';
+
+    /**
+     * Identifies a given version of a file
+     */
+    typedef struct FileStamp {
+        uint64_t mtime_;
+        uint64_t size_;
+        uint64_t inode_;
+    } FileStamp;
 }
 
 class FileUtils {
@@ -46,7 +62,26 @@ public:
     static bool fileExists(const std::string& fileName) noexcept;
 
     /**
-    * Retrieves the absolute path of a given file.
+     * Retrieves the size in bytes of a given file.
+     *
+     * @param fileName the path to the file
+     * @return the size of the file or 0 if not accessible
+     */
+    static size_t getFileSize(const std::string& fileName) noexcept;
+
+    /**
+     * Retrieves the modification time (in nanoseconds), size
+     * and inode of a given file.
+     *
+     * @param fileName the path to the file
+     * @param stamp the file stamp
+     * @return true if the stamp could be retrieved, false otherwise
+     */
+    static bool getFileStamp(const std::string& fileName, ftl::FileStamp& stamp) noexcept;
+
+    /**
+    * Retrieves the absolute path of a given file
+    * (lexically normalized, symbolic links are kept).
     *
     * @param filePath the path to the file
     * @return retrieves the absolute file path
@@ -61,6 +96,50 @@ public:
      */
     static bool createDirectories(const std::string& directory) noexcept;
 
+    /**
+     * Checks if a given path is a directory.
+     *
+     * @param path the path to check
+     * @return true if the path is a directory, false otherwise
+     */
+    static bool isDirectory(const std::string& path) noexcept;
+
+    /**
+     * Retrieves the files of a directory whose name matches the
+     * given glob pattern and its subdirectories (symbolic links
+     * to directories are not followed). The paths found are
+     * lexically normalized (i.e. without "." or ".." components).
+     *
+     * @param directory the directory to list
+     * @param pattern the glob pattern for the file names
+     * @param files the matching files found
+     * @param directories the subdirectories found
+     * @return true if the directory could be read, false otherwise
+     */
+    static bool listDirectory(const std::string& directory, const std::string& pattern,
+                              std::vector<std::string>& files, std::vector<std::string>& directories) noexcept;
+
+    /**
+     * Retrieves the (lexically normalized) paths matching
+     * a given glob pattern.
+     *
+     * @param pattern the glob pattern
+     * @param paths the matching paths found
+     * @return true if any path matched, false otherwise
+     */
+    static bool expandPattern(const std::string& pattern, std::vector<std::string>& paths) noexcept;
+
+    /**
+     * Reads the entries of a batch from a comma separated list,
+     * a file (@file) or the standard input (-). Entries are trimmed
+     * and blank ones and comments (starting with #) are skipped.
+     *
+     * @param source the entries source
+     * @param entries the entries read
+     * @return true if the source could be read, false otherwise
+     */
+    static bool readBatchEntries(const std::string& source, std::vector<std::string>& entries);
+
     /**
     * Retrieves the user's home directory,
     *
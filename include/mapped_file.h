@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_MAPPED_FILE_H
+#define PROPS_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Read-only view of a whole file contents. The file is
+ * memory mapped when the platform allows it, otherwise
+ * its contents are loaded in memory.
+ */
+class MappedFile {
+
+public:
+
+    /**
+     * Maps the given file in memory.
+     *
+     * @param fileName the path to the file to map
+     */
+    explicit MappedFile(const std::string& fileName);
+
+    /**
+     * Releases the mapping (if any).
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Checks whether the file could be opened.
+     *
+     * @return true if the file was opened, false otherwise
+     */
+    bool isOpen() const {
+        return open_;
+    }
+
+    /**
+     * Retrieves the start of the file contents.
+     *
+     * @return the file contents
+     */
+    const char* data() const {
+        return data_;
+    }
+
+    /**
+     * Retrieves the size in bytes of the file contents.
+     *
+     * @return the size of the file
+     */
+    size_t size() const {
+        return size_;
+    }
+
+private:
+
+    const char* data_{nullptr};
+    size_t size_{0};
+    bool open_{false};
+    bool mapped_{false};
+    std::vector<char> buffer_;
+};
+
+#endif //PROPS_MAPPED_FILE_H
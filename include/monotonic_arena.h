@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPS_MONOTONIC_ARENA_H
+#define PROPS_MONOTONIC_ARENA_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace arena {
+    static const size_t DEFAULT_BLOCK_SIZE = 1024;
+}
+
+/**
+ * Allocates contiguous arrays of elements from blocks of
+ * growing size which are only released all together when
+ * the arena is destroyed.
+ */
+template <typename T>
+class MonotonicArena {
+
+public:
+
+    /**
+     * Creates an empty arena.
+     *
+     * @param blockSize the number of elements of the first block
+     */
+    explicit MonotonicArena(const size_t& blockSize = arena::DEFAULT_BLOCK_SIZE) : nextBlockSize_(blockSize) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * Allocates a contiguous array of elements. The elements
+     * remain valid (at the same address) while the arena is alive.
+     *
+     * @param numElements the number of elements
+     * @return the first element of the array
+     */
+    T* allocate(const size_t& numElements) {
+        if (numElements > available_) {
+            size_t blockSize = std::max(numElements, nextBlockSize_);
+            blocks_.emplace_back(new T[blockSize]);
+            next_ = blocks_.back().get();
+            available_ = blockSize;
+            nextBlockSize_ *= 2;
+        }
+
+        T* elements = next_;
+        next_ += numElements;
+        available_ -= numElements;
+        return elements;
+    }
+
+private:
+
+    std::vector<std::unique_ptr<T[]>> blocks_;
+    T* next_{nullptr};
+    size_t available_{0};
+    size_t nextBlockSize_;
+};
+
+#endif //PROPS_MONOTONIC_ARENA_H
@@ -28,6 +28,8 @@ namespace edit_cmd {
     const char* const _SEPARATOR_     = "separator";
     const char* const _USE_REGEX_     = "expression";
     const char* const _PARTIAL_MATCH_ = "partial";
+    const char* const _BATCH_EDIT_    = "batch";
+    const char         BATCH_CHANGE_  = '=';
     const char *const _EDIT_CMD_      = "set";
 }
 
@@ -45,16 +47,19 @@ public:
                        "or the list of currently tracked files if no file is supplied."
                        "In case no options are specified, the master file of the tracker is the default file to lookup but "
                        "all tracked files can be queried simultaneously if a global search is performed. It is also possible "
-                       "to modify files present in tracker groups, or files using aliases.";
+                       "to modify files present in tracker groups, or files using aliases. Several keys can be modified "
+                       "at once in batch mode supplying the key=value changes as a comma separated list, a file (@file) "
+                       "or the standard input (-).";
 
-        args_ = { PropsArg::make_arg(edit_cmd::_EDIT_CMD_, { "<key>" ,"<value> [files...]" } , "Searches the files for a given key and replace its current value with the provided one",
+        args_ = { PropsArg::make_arg(edit_cmd::_EDIT_CMD_, { "<key|changes>" ,"[value] [files...]" } , "Searches the files for a given key and replace its current value with the provided one",
                                      { PropsOption::make_opt(edit_cmd::_ALIAS_FILE_, "Replaces the value in a tracked file using the alias", {"<alias>"}),
                                        PropsOption::make_opt(edit_cmd::_USE_REGEX_, "The key is expressed as a regular expression"),
                                        PropsOption::make_opt(edit_cmd::_IGNORE_CASE_, "Performs a case-insensitive search"),
                                        PropsOption::make_opt(edit_cmd::_MULTI_SEARCH_, "Perform a global replacement in all tracked files"),
                                        PropsOption::make_opt(edit_cmd::_PARTIAL_MATCH_, "Allow partial matches"),
                                        PropsOption::make_opt(edit_cmd::_GROUP_SEARCH_, "Perform a modification on files present in a tracker group", {"<group_name>"}),
-                                       PropsOption::make_opt(edit_cmd::_SEPARATOR_, "Separator between keys and values", {"<separator>"})
+                                       PropsOption::make_opt(edit_cmd::_SEPARATOR_, "Separator between keys and values", {"<separator>"}),
+                                       PropsOption::make_opt(edit_cmd::_BATCH_EDIT_, "Apply several changes in a single pass (key1=value1,... | @file | -)")
                                      })
                  };
     }
@@ -93,6 +98,25 @@ private:
      */
     void retrieveFileList(std::list<PropsFile>& fileList, Result& res);
 
+    /**
+     * Retrieves the number of arguments preceding the
+     * list of files (the key and value or the changes).
+     *
+     * @return the number of arguments before the files
+     */
+    size_t getNumEditArgs() const;
+
+    /**
+     * Retrieves the changes of a batch edit from a comma separated list,
+     * a file (@file) or the standard input (-). Blank lines and comments
+     * are skipped and the last change of a repeated key prevails.
+     *
+     * @param source the changes source
+     * @param keys the keys to modify
+     * @param values the new values of the keys
+     */
+    static void retrieveBatchChanges(const std::string& source, std::vector<std::string>& keys, std::vector<std::string>& values);
+
     /**
      * The property tracker
      */
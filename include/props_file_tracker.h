@@ -18,14 +18,50 @@
 #define PROPS_FILE_TRACKER_H
 
 #include <list>
+#include <deque>
+#include <vector>
 #include <iostream>
 #include <memory>
 #include <algorithm>
-#include <map>
+#include <unordered_map>
 #include "result.h"
+#include "file_utils.h"
 #include "props_file.h"
 #include "props_tracker.h"
 
+namespace tracker {
+    static const size_t NO_ENTRY = static_cast<size_t>(-1);
+
+    /**
+     * A slot of the tracked files storage. Used slots are
+     * linked in tracking order and in the order they were
+     * added to their group, free slots are reused.
+     */
+    typedef struct TrackedEntry {
+        PropsFile file_;
+        size_t prev_;
+        size_t next_;
+        size_t groupPrev_;
+        size_t groupNext_;
+        bool used_;
+    } TrackedEntry;
+
+    /**
+     * The first and last files of a group (and its size).
+     */
+    typedef struct TrackedGroup {
+        size_t first_;
+        size_t last_;
+        size_t size_;
+    } TrackedGroup;
+}
+
+/**
+ * Keeps the tracked files in a contiguous storage indexed
+ * by path, alias and group so every operation on a single
+ * file takes constant time regardless of the number of
+ * files tracked.
+ */
 class PropsFileTracker : public PropsTracker {
 
 
@@ -109,9 +145,7 @@ public:
      *
      * @return the list of tracked files
      */
-    const std::list<PropsFile>& getTrackedFiles() const override {
-        return trackedFiles_;
-    }
+    std::list<PropsFile> getTrackedFiles() const override;
 
     /**
      * Stores the current configuration of the tracker
@@ -164,15 +198,10 @@ public:
      * group.
      *
      * @param group the group name
-     * @return the list of files of the group
-     */
-    const std::list<PropsFile*>* getGroup(const std::string& group) override {
-        std::list<PropsFile *> *groupFiles = nullptr;
-        if (trackedGroups_.count(group) != 0) {
-            groupFiles = &trackedGroups_.at(group);
-        }
-        return groupFiles;
-    }
+     * @param files the list to append the files of the group to
+     * @return true if the group exists, false otherwise
+     */
+    bool getGroup(const std::string& group, std::list<PropsFile>& files) const override;
 
     /**
      * Moves the object specified by its file/alias
@@ -208,6 +237,23 @@ public:
      */
     Result renameGroup(const std::string& sourceGroup, const std::string& targetGroup, const bool& force) override;
 
+    /**
+     * Removes from the given list the files that cannot
+     * be read, warning about every skipped file.
+     *
+     * @param files the files to validate
+     */
+    void validate(std::list<PropsFile>& files) const override;
+
+    /**
+     * Checks that all tracked files can be read, optionally
+     * untracking the ones that cannot.
+     *
+     * @param untrack untracks the files that cannot be read
+     * @return the result of the operation
+     */
+    Result verify(const bool& untrack) override;
+
 private:
 
     /**
@@ -216,6 +262,70 @@ private:
      */
     void parseTrackerConfig();
 
+    /**
+     * Reads the files stored in the given tracker config file.
+     *
+     * @param configFilePath the path to the tracker config file
+     * @param files the files read
+     */
+    static void readTrackerConfig(const std::string& configFilePath, std::list<PropsFile>& files);
+
+    /**
+     * Reads the files stored in the tracker snapshot if it
+     * matches the given version of the tracker config file.
+     *
+     * @param stamp the tracker config file stamp
+     * @param files the files read
+     * @return true if read, false otherwise
+     */
+    static bool readSnapshot(const ftl::FileStamp& stamp, std::list<PropsFile>& files);
+
+    /**
+     * Writes the given files to the tracker snapshot for the
+     * given version of the tracker config file (failing to
+     * write it is not an error).
+     *
+     * @param stamp the tracker config file stamp
+     * @param files the files to write
+     */
+    static void writeSnapshot(const ftl::FileStamp& stamp, const std::list<PropsFile>& files);
+
+    /**
+     * Replays the changes stored in the tracker journal on the
+     * given files. Journals started from another version of the
+     * tracker config file (i.e. edited by hand) are replayed on top
+     * of it too, warning that they must be folded into the config.
+     *
+     * @param stamp the tracker config file stamp
+     * @param files the files read from the tracker config file
+     * @return true if a stale journal was replayed, false otherwise
+     */
+    bool readJournal(const ftl::FileStamp& stamp, std::list<PropsFile>& files);
+
+    /**
+     * Records the current state of the given file in the
+     * pending journal changes.
+     *
+     * @param propsFile the props file
+     */
+    void journalFile(const PropsFile& propsFile);
+
+    /**
+     * Records the removal of the given file in the
+     * pending journal changes.
+     *
+     * @param fileName the path to the file
+     */
+    void journalRemoval(const std::string& fileName);
+
+    /**
+     * Appends the pending changes to the tracker journal unless
+     * the tracker config file needs to be rewritten (not existing,
+     * journal too large or unusable).
+     *
+     * @return true if appended, false if a full rewrite is needed
+     */
+    bool appendTrackerJournal();
 
     /**
      * Sets the given file as master.
@@ -250,6 +360,28 @@ private:
      */
     void addFiles(std::list<PropsFile> &files, Result &result, const bool& updateConfig = true);
 
+    /**
+     * Adds the given file to the tracker once its absolute
+     * path has been resolved and checked.
+     *
+     * @param file the file to add
+     * @param fullFilePath the absolute path to the file
+     * @param exists true if the file exists
+     * @param result the result of the operation
+     */
+    void addResolvedFile(PropsFile &file, const std::string& fullFilePath, const bool& exists, Result &result);
+
+    /**
+     * Resolves the absolute paths of the given files and checks
+     * their existence using the worker pool (reporting the
+     * progress on a terminal for large lists).
+     *
+     * @param files the files to resolve
+     * @param fullFilePaths the absolute paths of the files
+     * @param exists the existence flag of every file
+     */
+    static void resolveFiles(const std::vector<PropsFile*>& files, std::vector<std::string>& fullFilePaths, std::vector<char>& exists);
+
     /**
      * Removes the given file from the tracker using the file path
      *
@@ -265,18 +397,18 @@ private:
     void removeFileByAlias(const std::string &fileAlias, Result &result);
 
     /**
-     * Checks the file is valid and keeps a reference
-     * in the tracker.
+     * Keeps a reference of the file in the tracker
+     * if not already tracked.
      *
      * @param propsFile the properties to store in the tracker
      */
-    Result storeFile(PropsFile& propsFile);
+    Result trackFile(PropsFile& propsFile);
 
     /**
      * Updates or creates if needed, the tracker config file with the current
-     * tracked configuration.
+     * tracked configuration, discarding the journal.
      */
-    void updateTrackerConfig() const;
+    void updateTrackerConfig();
 
     /**
      * Writes the tracker current configuration to the given output file.
@@ -286,11 +418,48 @@ private:
     void writeTrackerConfig(const std::string& outputFilePath) const;
 
     /**
-     * Removes the given file from its groups (if any).
+     * Stores a copy of the given file in a free slot (or a
+     * new one) linking it at the end of the tracked files.
      *
      * @param propsFile the props file
+     * @return the slot of the file
      */
-    void removeFileFromGroup(PropsFile* propsFile);
+    size_t allocateEntry(const PropsFile& propsFile);
+
+    /**
+     * Removes the file stored in the given slot from the
+     * tracker and its indexes, releasing the slot.
+     *
+     * @param entry the slot of the file
+     */
+    void untrackEntry(const size_t& entry);
+
+    /**
+     * Appends the file stored in the given slot to the
+     * given group, creating the group if not existing.
+     *
+     * @param entry the slot of the file
+     * @param groupName the (normalized) group name
+     */
+    void linkGroup(const size_t& entry, const std::string& groupName);
+
+    /**
+     * Removes the file stored in the given slot from its
+     * group, removing the group once empty.
+     *
+     * @param entry the slot of the file
+     */
+    void unlinkGroup(const size_t& entry);
+
+    /**
+     * Retrieves the slot of the given tracked file.
+     *
+     * @param propsFile the props file
+     * @return the slot of the file
+     */
+    size_t getEntry(const PropsFile* propsFile) const {
+        return trackedMapFiles_.at(propsFile->getFileName());
+    }
 
     /**
      * Print the tracked group.
@@ -301,17 +470,39 @@ private:
      */
     void printTrackedGroup(std::ostream &output, size_t maxFileNameSize, const std::string& groupName) const;
 
-    /** The list of tracked files */
-    std::list<PropsFile> trackedFiles_;
+    /** The storage of tracked files (slots never move) */
+    std::deque<tracker::TrackedEntry> entries_;
+
+    /** The slots released to be reused */
+    std::vector<size_t> freeEntries_;
+
+    /** The first and last tracked files */
+    size_t firstEntry_{tracker::NO_ENTRY};
+    size_t lastEntry_{tracker::NO_ENTRY};
 
-    /** The map of tracked files */
-    std::map<std::string,PropsFile*> trackedMapFiles_;
+    /** The number of tracked files */
+    size_t numTracked_{0};
 
-    /** The map of aliased files */
-    std::map<std::string, PropsFile*> aliasedMapFiles_;
+    /** The slots of the tracked files by path */
+    std::unordered_map<std::string, size_t> trackedMapFiles_;
+
+    /** The slots of the aliased files by alias */
+    std::unordered_map<std::string, size_t> aliasedMapFiles_;
 
     /** The groups of tracked files */
-    std::map<std::string, std::list<PropsFile*>> trackedGroups_;
+    std::unordered_map<std::string, tracker::TrackedGroup> trackedGroups_;
+
+    /** The changes not yet written to the journal */
+    std::string journal_;
+
+    /** The size of the journal file in use (0 if none) */
+    size_t journalSize_{0};
+
+    /** The master file last written to the config or journal */
+    const PropsFile* journaledMaster_{nullptr};
+
+    /** Forces a full rewrite of the config on next save */
+    bool compact_{false};
 
 };
 
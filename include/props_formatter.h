@@ -18,6 +18,8 @@
 #define PROPS_FORMATTER_H
 
 #include "props_search_result.h"
+#include "props_result_sink.h"
+#include <memory>
 #include <sstream>
 
 class PropsFormatter {
@@ -35,6 +37,16 @@ public:
      */
     virtual void format(const PropsSearchResult* result, std::ostream& out) const = 0;
 
+    /**
+     * Creates a sink formatting the results of a (non batch)
+     * search file by file as they are received.
+     *
+     * @param searchOptions the search options
+     * @param out the output stream
+     * @return the sink
+     */
+    virtual std::unique_ptr<PropsResultSink> createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const = 0;
+
 };
 
 #endif //PROPS_FORMATTER_H
@@ -24,6 +24,8 @@
 namespace formatter {
     static const char DEFAULT[] = "DEFAULT";
     static const char JSON_FORMATTER[] = "JSON_FORMATTER";
+    static const char NDJSON_FORMATTER[] = "NDJSON_FORMATTER";
+    static const char MSGPACK_FORMATTER[] = "MSGPACK_FORMATTER";
 }
 
 class PropsFormatterFactory {
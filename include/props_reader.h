@@ -17,12 +17,21 @@
 #ifndef PROPS_READER_H
 #define PROPS_READER_H
 
+#include <condition_variable>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <props_search_result.h>
+#include <props_result_sink.h>
 #include <props_file.h>
-#include <deque>
+#include <vector>
+
+class LiteralMatcher;
+class PropsRegex;
+class BatchMatcher;
+class MappedFile;
+class SearchScheduler;
 
 /**
  * Namespace for search options
@@ -37,10 +46,39 @@ namespace search {
     static const char KEY_ENABLE_HIGHLIGHT[] = "search.highlight_results";
     static const bool DEFAULT_ENABLE_HIGHLIGHT = true;
 
+    /**
+     * The matches found in every range of a file (each
+     * range written by a single worker), the mapped contents
+     * they reference and the number of ranges still pending.
+     */
+    typedef struct FileMatches {
+        std::shared_ptr<const MappedFile> source_;
+        std::vector<std::vector<p_search_res::Match>> ranges_;
+        size_t pendingRanges_;
+    } FileMatches;
+
+    /**
+     * Notifies the completion of the ranges of the files
+     */
+    typedef struct SearchProgress {
+        std::mutex mutex_;
+        std::condition_variable rangeDone_;
+        bool aborted_;
+    } SearchProgress;
+
     typedef struct FileSearchData {
         PropsSearchOptions* searchOptions_;
-        void* regex_;
-        std::deque<PropsFile>* filesQueue_;
+        std::shared_ptr<const PropsRegex> regex_;
+        const LiteralMatcher* literalMatcher_;
+        const BatchMatcher* batchMatcher_;
+        bool useIndex_;
+        bool useBloomFilter_;
+        std::vector<std::string> trigramLiterals_;
+        const std::vector<PropsFile>* files_;
+        const std::vector<std::shared_ptr<const MappedFile>>* mappedFiles_;
+        SearchScheduler* scheduler_;
+        std::vector<FileMatches>* fileMatches_;
+        SearchProgress* progress_;
         PropsSearchResult* searchResult_;
     } FileSearchData;
 }
@@ -54,15 +92,17 @@ public:
 
     /**
      *  Finds the value of the given key searching in the mater tracked file
-     *  or globally on every tracked file.
+     *  or globally on every tracked file. The matches of every file are
+     *  sent to the sink (if supplied) as soon as the file is searched
+     *  instead of being kept in the result.
      *
      *  @param key the key to find
      *  @param files the list of files to search
-     *  @param global the flag enabling global search
+     *  @param sink the sink receiving the matches file by file
      *
      * @return the results of the search
      */
-     static std::unique_ptr<PropsSearchResult> processSearch(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files);
+     static std::unique_ptr<PropsSearchResult> processSearch(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files, PropsResultSink* sink = nullptr);
 
 private:
 
@@ -83,13 +123,21 @@ private:
     static void buildRegex(const PropsSearchOptions& searchOptions, std::string& regex_str);
 
     /**
-     * Retrieves the search data for the given options and file list.
+     * Retrieves the compiled regular expression for the given
+     * search options (reusing an already compiled one if possible).
+     *
+     * @param searchOptions the search options
+     * @return the compiled regular expression
+     */
+    static std::shared_ptr<const PropsRegex> compileRegex(const PropsSearchOptions& searchOptions);
+
+    /**
+     * Retrieves the search data for the given options.
      *
      * @param searchOptions the search options
-     * @param files the list of files to process
      * @return the built search data
      */
-    static search::FileSearchData buildSearchData(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files);
+    static search::FileSearchData buildSearchData(PropsSearchOptions& searchOptions);
 
 };
 
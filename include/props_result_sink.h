@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPS_RESULT_SINK_H
+#define PROPS_RESULT_SINK_H
+
+#include "props_search_result.h"
+
+/**
+ * Receives the matches of a search file by file as soon
+ * as every file is searched (in the same order the results
+ * would be shown), so they can be output without waiting
+ * for the whole search to finish.
+ */
+class PropsResultSink {
+
+public:
+    PropsResultSink() = default;
+    virtual ~PropsResultSink() = default;
+
+    /**
+     * Receives the matches found in a given file. The matches
+     * are only valid during the call.
+     *
+     * @param fileName the name of the file
+     * @param matches the matches found in line order
+     */
+    virtual void add(const std::string& fileName, const p_search_res::MatchRange& matches) = 0;
+
+    /**
+     * Completes the output once all files were received.
+     */
+    virtual void finish() = 0;
+
+};
+
+#endif //PROPS_RESULT_SINK_H
@@ -29,7 +29,13 @@ namespace search_cmd {
     const char* const _SEPARATOR_     = "separator";
     const char* const _USE_REGEX_     = "expression";
     const char* const _USE_JSON_      = "json";
+    const char* const _OUTPUT_FORMAT_ = "format";
+    const char* const _FORMAT_TEXT_   = "text";
+    const char* const _FORMAT_JSON_   = "json";
+    const char* const _FORMAT_NDJSON_ = "ndjson";
+    const char* const _FORMAT_MSGPACK_ = "msgpack";
     const char* const _PARTIAL_MATCH_ = "partial";
+    const char* const _BATCH_SEARCH_  = "batch";
     const char *const _SEARCH_CMD_    = "search";
 }
 
@@ -47,7 +53,8 @@ public:
                        "or the list of currently tracked files if no file is supplied."
                        "In case no options are specified, the master file of the tracker is the default file to lookup but "
                        "all tracked files can be queried simultaneously if a global search is performed. It is also possible "
-                       "to query files present in tracker groups, or files using aliases.";
+                       "to query files present in tracker groups, or files using aliases. Several terms can be searched "
+                       "at once in batch mode supplying them as a comma separated list, a file (@file) or the standard input (-).";
 
         args_ = { PropsArg::make_arg(search_cmd::_SEARCH_CMD_, { "<term> [files...]" } , "Searches the files for a given key/value",
                                      { PropsOption::make_opt(search_cmd::_ALIAS_FILE_, "Searches in a tracked file using the alias", {"<alias>"}),
@@ -58,7 +65,9 @@ public:
                                        PropsOption::make_opt(search_cmd::_PARTIAL_MATCH_, "Allow partial matches"),
                                        PropsOption::make_opt(search_cmd::_GROUP_SEARCH_, "Perform a search by a tracker group", {"<group_name>"}),
                                        PropsOption::make_opt(search_cmd::_SEPARATOR_, "Separator between keys and values", {"<separator>"}),
-                                       PropsOption::make_opt(search_cmd::_USE_JSON_, "Output in JSON format") }) };
+                                       PropsOption::make_opt(search_cmd::_USE_JSON_, "Output in JSON format"),
+                                       PropsOption::make_opt(search_cmd::_OUTPUT_FORMAT_, "Output format (text | json | ndjson | msgpack)", {"<format>"}),
+                                       PropsOption::make_opt(search_cmd::_BATCH_SEARCH_, "Search several terms in a single pass (term1,term2,... | @file | -)") }) };
     }
 
     /**
@@ -95,6 +104,24 @@ private:
      */
     void retrieveFileList(std::list<PropsFile>& fileList, Result& res);
 
+    /**
+     * Retrieves the name of the formatter for the
+     * output format supplied (if any).
+     *
+     * @return the formatter name (empty for the default one)
+     */
+    std::string retrieveFormatterName() const;
+
+    /**
+     * Retrieves the terms of a batch search from a comma separated list,
+     * a file (@file) or the standard input (-). Blank lines and comments
+     * are skipped and duplicated terms are removed.
+     *
+     * @param source the terms source
+     * @param keys the list of terms
+     */
+    static void retrieveBatchKeys(const std::string& source, std::vector<std::string>& keys);
+
     /**
      * The property tracker
      */
@@ -21,6 +21,7 @@
 #define PROPS_SEARCH_OPTIONS_H
 
 #include <string>
+#include <vector>
 #include "generic_options.h"
 
 /**
@@ -181,9 +182,59 @@ public:
         replace_ = replace;
     }
 
+    /**
+     * Retrieves the list of terms of a batch search
+     *
+     * @return the batch terms
+     */
+    const std::vector<std::string> &getBatchKeys() const {
+        return batchKeys_;
+    }
+
+    /**
+     * Sets the list of terms to search in a single pass
+     *
+     * @param batchKeys the batch terms
+     */
+    void setBatchKeys(const std::vector<std::string> &batchKeys) {
+        batchKeys_ = batchKeys;
+    }
+
+    /**
+     * Checks whether several terms are searched
+     * at once or not.
+     *
+     * @return true if batch search, false otherwise
+     */
+    bool isBatch() const {
+        return !batchKeys_.empty();
+    }
+
+    /**
+     * Retrieves the replacements of the batch terms
+     * (in the same order than the terms)
+     *
+     * @return the batch replacements
+     */
+    const std::vector<std::string> &getBatchReplacements() const {
+        return batchReplacements_;
+    }
+
+    /**
+     * Sets the replacements of the batch terms
+     * (in the same order than the terms)
+     *
+     * @param batchReplacements the batch replacements
+     */
+    void setBatchReplacements(const std::vector<std::string> &batchReplacements) {
+        batchReplacements_ = batchReplacements;
+    }
+
 private:
 
     std::string key_;
+    std::vector<std::string> batchKeys_;
+    std::vector<std::string> batchReplacements_;
     global_options::Opt caseSensitive_;
     std::string separator_;
     std::string replacement_;
@@ -21,27 +21,151 @@
 
 #include "props_result.h"
 #include "props_search_options.h"
+#include "monotonic_arena.h"
 #include <string>
-#include <map>
 #include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include <pcre_stringpiece.h>
 
-namespace p_search_res {
+class MappedFile;
 
-    typedef struct StringMatch {
-        std::string str_;
-        size_t position;
-    } StringMatch;
+namespace p_search_res {
 
+    /**
+     * A matched line. The line, key and value reference the
+     * mapped contents of the file (kept by the search result)
+     * and the term is the index of the batch term matched.
+     */
     typedef struct Match {
-            std::string input_;
-            PropsSearchOptions searchOptions_;
-            std::string fullLine_;
-            StringMatch key_;
-            StringMatch value_;
+            size_t termId_;
+            size_t lineOffset_;
+            pcrecpp::StringPiece line_;
+            pcrecpp::StringPiece key_;
+            pcrecpp::StringPiece value_;
     } Match;
 
-    typedef std::map<std::string, std::list<Match>> result_map;
+    /**
+     * A view of contiguous matches stored in the result
+     */
+    class MatchRange {
+
+    public:
+
+        MatchRange() = default;
+
+        MatchRange(const Match* begin, const Match* end) : begin_(begin), end_(end) {}
+
+        const Match* begin() const {
+            return begin_;
+        }
+
+        const Match* end() const {
+            return end_;
+        }
+
+        size_t size() const {
+            return static_cast<size_t>(end_ - begin_);
+        }
+
+        bool empty() const {
+            return begin_ == end_;
+        }
+
+    private:
+
+        const Match* begin_{nullptr};
+        const Match* end_{nullptr};
+    };
+
+    /**
+     * The matches found in a file (in line order or
+     * grouped by term for batch searches).
+     */
+    typedef struct FileResult {
+        const std::string* fileName_;
+        MatchRange matches_;
+    } FileResult;
+
+    typedef std::vector<FileResult> result_view;
+
+    /**
+     * The whole key and value of the property in a matched
+     * line (and their offsets in the file).
+     */
+    typedef struct Property {
+        pcrecpp::StringPiece key_;
+        size_t keyOffset_;
+        pcrecpp::StringPiece value_;
+        size_t valueOffset_;
+    } Property;
+
+    /**
+     * Retrieves the property in the line of the given match.
+     * Matches only hold the whole value for key searches and
+     * the whole key for value searches (the other part is
+     * the matched term).
+     *
+     * @param match the match
+     * @param separatorSize the size of the key/value separator
+     * @param matchValue the flag set for value searches
+     * @return the property
+     */
+    Property getProperty(const Match& match, const size_t& separatorSize, const bool& matchValue);
+
+    /**
+     * Computes the line numbers of the matches of a file
+     * counting the line breaks in the contents they reference
+     * (since the previous match if found in line order).
+     */
+    class LineCounter {
+
+    public:
+
+        /**
+         * Retrieves the line number of the given match.
+         *
+         * @param match the match
+         * @return the line number (starting at 1)
+         */
+        size_t getLineNumber(const Match& match);
+
+    private:
+
+        size_t lineNumber_{1};
+        size_t offset_{0};
+    };
+
+    /**
+     * Holds the line numbers of the matches of every file
+     * computed once in line order, for results not shown
+     * in line order (i.e. batch results grouped by term).
+     */
+    class LineNumbers {
+
+    public:
+
+        /**
+         * Computes the line numbers of the matches of the given files.
+         *
+         * @param files the matches of every file
+         */
+        explicit LineNumbers(const result_view& files);
+
+        /**
+         * Retrieves the line numbers of the matches of
+         * the given file (or part of its matches).
+         *
+         * @param fileResult the matches of a file
+         * @return the line numbers (in the order of the matches)
+         */
+        const size_t* get(const FileResult& fileResult) const;
+
+    private:
+
+        std::unordered_map<const std::string*, std::pair<const Match*, std::vector<size_t>>> files_;
+    };
 }
 
 class PropsSearchResult : public PropsResult {
@@ -65,31 +189,62 @@ public:
     }
 
     /**
-     * Appends the pair key/value found in the given file
-     * to the results map.
+     * Appends the matches found in the given file (in line
+     * order) to the results, grouping them by the matched
+     * term for batch searches.
      *
-     * @param file the file where the key was found
-     * @param value the value found
+     * @param file the file where the matches were found
+     * @param ranges the matches found in every range of the file
      */
-    void add(const std::string &file, const p_search_res::Match &value);
+    void add(const std::string &file, const std::vector<const std::vector<p_search_res::Match>*>& ranges);
 
     /**
-     * Retrieves the results for the given file.
+     * Keeps the contents of a mapped file referenced
+     * by the matches while the result is alive.
      *
-     * @param fileName the list of file names to retrieve results from
-     * @param results the results for the given file
+     * @param source the mapped file
      */
-    p_search_res::result_map get(const std::list<std::string> &fileNames) const;
+    void addSource(const std::shared_ptr<const MappedFile>& source) {
+        if (sources_.empty() || (sources_.back() != source)) {
+            sources_.push_back(source);
+        }
+    }
 
     /**
-     * Retrieves all results
+     * Retrieves the term of a given match.
      *
-     * @param results the results for all files
+     * @param match the match
+     * @return the searched term matched
      */
-    const p_search_res::result_map& getFileKeys() const {
-        return fileKeys_;
+    const std::string& getTerm(const p_search_res::Match& match) const {
+        return searchOptions_.isBatch() ? searchOptions_.getBatchKeys()[match.termId_] : searchOptions_.getKey();
     }
 
+    /**
+     * Retrieves the results for the given files
+     * sorted by file name.
+     *
+     * @param fileNames the list of file names to retrieve results from
+     * @return the results for the given files
+     */
+    p_search_res::result_view get(const std::list<std::string> &fileNames) const;
+
+    /**
+     * Retrieves all results sorted by file name.
+     *
+     * @return the results for all files
+     */
+    p_search_res::result_view getFileKeys() const;
+
+    /**
+     * Retrieves the results of a batch search term
+     * sorted by file name.
+     *
+     * @param termId the index of the batch term
+     * @return the results of the term for all files
+     */
+    p_search_res::result_view getTermResults(const size_t& termId) const;
+
     /**
      * Formats the contents of the result in an
      * output stream.
@@ -99,28 +254,40 @@ public:
     void format(std::ostream& out) const override;
 
     /**
-     * Enables/disables JSON output
+     * Sets the name of the formatter of the output
      *
-     * @param enableJson true to enable, false otherwise
+     * @param formatterName the formatter name (empty for the default one)
      */
-    void setEnableJson(const bool& enableJson) {
-        enableJson_ = enableJson;
+    void setFormatterName(const std::string& formatterName) {
+        formatterName_ = formatterName;
     }
 
     /**
-     * Check if JSON output is enabled
+     * Retrieves the name of the formatter of the output
      *
-     * @return true if JSON output enabled, false otherwise
+     * @return the formatter name (empty for the default one)
      */
-    const bool& isEnableJson() const {
-        return enableJson_;
+    const std::string& getFormatterName() const {
+        return formatterName_;
     }
 
 private:
 
-    p_search_res::result_map fileKeys_;
+    /**
+     * Retrieves the identifiers of the files with matches
+     * sorted by file name.
+     *
+     * @param fileIds the sorted file identifiers
+     */
+    void getSortedFiles(std::vector<size_t>& fileIds) const;
+
+    MonotonicArena<p_search_res::Match> matches_;
+    std::vector<std::string> fileNames_;
+    std::unordered_map<std::string, size_t> fileIds_;
+    std::vector<p_search_res::MatchRange> fileMatches_;
+    std::vector<std::shared_ptr<const MappedFile>> sources_;
     PropsSearchOptions searchOptions_;
-    bool enableJson_{false};
+    std::string formatterName_;
 };
 
 
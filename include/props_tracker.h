@@ -90,7 +90,7 @@ public:
      *
      * @return the list of tracked files
      */
-    virtual const std::list<PropsFile>& getTrackedFiles() const = 0;
+    virtual std::list<PropsFile> getTrackedFiles() const = 0;
 
     /**
      * Stores the current configuration of the tracker
@@ -180,9 +180,10 @@ public:
      * group.
      *
      * @param group the group name
-     * @return the list of files of the group
+     * @param files the list to append the files of the group to
+     * @return true if the group exists, false otherwise
      */
-    virtual const std::list<PropsFile*>* getGroup(const std::string& group) = 0;
+    virtual bool getGroup(const std::string& group, std::list<PropsFile>& files) const = 0;
 
     /**
      * Moves the object specified by its file/alias
@@ -217,6 +218,23 @@ public:
      */
     virtual Result renameGroup(const std::string& sourceGroup, const std::string& targetGroup, const bool& force) = 0;
 
+    /**
+     * Removes from the given list the files that cannot
+     * be read, warning about every skipped file.
+     *
+     * @param files the files to validate
+     */
+    virtual void validate(std::list<PropsFile>& files) const = 0;
+
+    /**
+     * Checks that all tracked files can be read, optionally
+     * untracking the ones that cannot.
+     *
+     * @param untrack untracks the files that cannot be read
+     * @return the result of the operation
+     */
+    virtual Result verify(const bool& untrack) = 0;
+
 protected:
 
     /** The master file */
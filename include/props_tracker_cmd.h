@@ -17,6 +17,7 @@
 #ifndef PROPS_TRACKER_COMMAND_H
 #define PROPS_TRACKER_COMMAND_H
 
+#include <vector>
 #include "props_cmd.h"
 #include "props_tracker.h"
 
@@ -25,6 +26,9 @@ namespace tracker_cmd {
     const char* const _ALIAS_FILE_               = "alias";
     const char* const _MASTER_FILE_              = "master";
     const char* const _GROUP_NAME_               = "group";
+    const char* const _RECURSIVE_                = "recursive";
+    const char* const _FILE_PATTERN_             = "pattern";
+    const char* const _DEFAULT_FILE_PATTERN_     = "*.properties";
     const char* const  _FORCE_MOVE_              = "force";
     const char* const _OLD_GROUP_NAME_           = "old_group";
     const char* const _TRACKER_ADD_CMD_          = "add";
@@ -37,6 +41,7 @@ namespace tracker_cmd {
     const char* const _TRACKER_SET_MASTER_CMD_   = "set-master";
     const char* const _TRACKER_SET_ALIAS_CMD_    = "set-alias";
     const char* const _TRACKER_CLEAR_CMD_        = "clear";
+    const char* const _TRACKER_VERIFY_CMD_       = "verify";
 }
 
 class PropsTrackerCommand : public PropsCommand {
@@ -59,9 +64,13 @@ public:
         args_ = { PropsArg::make_cmd(tracker_cmd::_TRACKER_ADD_CMD_, { "<file...>" } , "Adds the file(s) to the tracker",
                            { PropsOption::make_opt(tracker_cmd::_ALIAS_FILE_, "Sets an alias for the file", {"<name>"}),
                              PropsOption::make_opt(tracker_cmd::_MASTER_FILE_, "Sets the file as master"),
-                             PropsOption::make_opt(tracker_cmd::_GROUP_NAME_, "Sets a group for the file", {"<name>"})}),
+                             PropsOption::make_opt(tracker_cmd::_GROUP_NAME_, "Sets a group for the file", {"<name>"}),
+                             PropsOption::make_opt(tracker_cmd::_RECURSIVE_, "Adds the files found in the given directories and their subdirectories"),
+                             PropsOption::make_opt(tracker_cmd::_FILE_PATTERN_, "Glob pattern of the files added from directories (requires recursive, default \"*.properties\")", {"<glob>"})}),
                   PropsArg::make_cmd(tracker_cmd::_TRACKER_LS_CMD_ , "List all tracked files"),
                   PropsArg::make_cmd(tracker_cmd::_TRACKER_CLEAR_CMD_ , "Removes all tracked files"),
+                  PropsArg::make_cmd(tracker_cmd::_TRACKER_VERIFY_CMD_ , "Checks that all tracked files can be read",
+                                     { PropsOption::make_opt(tracker_cmd::_TRACKER_UNTRACK_CMD_, "Untracks the files that cannot be read") }),
                   PropsArg::make_cmd(tracker_cmd::_TRACKER_SET_MASTER_CMD_ , { "<file|alias>" } , "Sets the file as master",
                            { PropsOption::make_opt(tracker_cmd::_ALIAS_FILE_, "the name specified is an alias") }),
                   PropsArg::make_cmd(tracker_cmd::_TRACKER_SET_ALIAS_CMD_, { "<file>" } , "Sets an alias for the tracked file",
@@ -111,6 +120,27 @@ private:
      */
     Result trackFiles();
 
+    /**
+     * Retrieves the files to track from the arguments, expanding
+     * glob patterns and (if recursive) directories. Directories
+     * are rejected unless recursive.
+     *
+     * @param files the files to track
+     * @return the result of the operation
+     */
+    Result getFilesToTrack(std::vector<std::string>& files);
+
+    /**
+     * Retrieves the files matching the given pattern in the given
+     * directories and their subdirectories, listing the directories
+     * of every level in parallel.
+     *
+     * @param directories the directories to traverse
+     * @param pattern the glob pattern for the file names
+     * @param files the matching files found
+     */
+    static void traverseDirectories(std::vector<std::string> directories, const std::string& pattern, std::vector<std::string>& files);
+
     /**
      * Removes from the tracker the selected filed using the file
      * name or the alias (if set).
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPS_WRITER_H
+#define PROPS_WRITER_H
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <props_search_result.h>
+#include <props_file.h>
+#include <file_utils.h>
+
+namespace writer {
+    static const char TEMP_FILE_SUFFIX[] = ".XXXXXX";
+    static const char BACKUP_FILE_SUFFIX[] = ".bak";
+    static const char JOURNAL_FOLDER[] = "journal";
+    static const char JOURNAL_FILE_NAME[] = "edit.journal";
+    static const char JOURNAL_LOCK_NAME[] = "edit.lock";
+    static const char JOURNAL_COMMITTED[] = "COMMITTED";
+    static const size_t COPY_BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * The state of the modification of a single file
+     */
+    typedef struct FileEdit {
+        std::string fileName_;
+        std::string fullPath_;
+        std::string tempPath_;
+        std::string backupPath_;
+        std::string error_;
+        ftl::FileStamp stamp_;
+    } FileEdit;
+}
+
+/**
+ * Performs the modification of values in properties files. All
+ * the files of an edit are modified or none of them is. Edits
+ * are serialized among processes through the journal lock.
+ */
+class PropsWriter {
+
+public:
+
+    /**
+     * Removes default constructor
+     */
+    PropsWriter() = delete;
+
+    /**
+     *  Replaces the value of the keys matching the search options
+     *  with the replacement of the options (or the replacement of
+     *  every term in batch mode) in the given files.
+     *
+     *  @param searchOptions the search options
+     *  @param files the list of files to modify
+     *  @param res the output result in case of errors
+     *
+     * @return the matches replaced
+     */
+    static std::unique_ptr<PropsSearchResult> processEdit(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files, Result& res);
+
+    /**
+     * Completes or rolls back an edit interrupted before
+     * finishing, as recorded in the journal (if any). Nothing
+     * is done while another process is editing.
+     */
+    static void recover();
+
+private:
+
+    /**
+     * Searches the given files (once per resolved path) and
+     * replaces the values found, all files or none.
+     *
+     *  @param searchOptions the search options
+     *  @param files the list of files to modify
+     *  @param res the output result in case of errors
+     *
+     * @return the matches replaced
+     */
+    static std::unique_ptr<PropsSearchResult> editFiles(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files, Result& res);
+
+    /**
+     * Completes or rolls back the edit recorded in the
+     * journal (if any). The journal lock must be held.
+     */
+    static void recoverJournal();
+
+    /**
+     * Takes the exclusive lock of the journal, held
+     * by the process editing or recovering.
+     *
+     * @param wait true to wait for the lock, false to fail if held
+     * @param lock the descriptor holding the lock
+     * @return true if locked, false otherwise
+     */
+    static bool lockJournal(const bool& wait, int& lock);
+
+    /**
+     * Releases the lock of the journal.
+     *
+     * @param lock the descriptor holding the lock
+     */
+    static void unlockJournal(const int& lock);
+
+    /**
+     * Writes the modified contents of a file to a temporary file
+     * in the same directory, synced to disk. The file must not
+     * have changed since it was searched.
+     *
+     * @param edit the file to modify
+     * @param searchOptions the search options (with the replacements)
+     * @param matches the matches in line order
+     * @return true if the temporary file was written, false otherwise
+     */
+    static bool prepareFile(writer::FileEdit& edit, const PropsSearchOptions& searchOptions, const p_search_res::MatchRange& matches);
+
+    /**
+     * Replaces the files with their temporary files keeping
+     * a backup of the originals until all of them are replaced.
+     * No file is replaced if any changed since it was searched.
+     *
+     * @param edits the prepared files
+     * @param error the error message in case of failure
+     * @return true if all files were replaced, false if none was
+     */
+    static bool commit(std::vector<writer::FileEdit>& edits, std::string& error);
+
+    /**
+     * Restores the files already replaced from their backups and
+     * removes the temporary files of an edit.
+     *
+     * @param edits the files of the edit
+     */
+    static void rollback(const std::vector<writer::FileEdit>& edits);
+
+    /**
+     * Removes the backups and temporary files of an edit.
+     *
+     * @param edits the files of the edit
+     */
+    static void cleanUp(const std::vector<writer::FileEdit>& edits);
+
+    /**
+     * Writes the journal of an edit, synced to disk.
+     *
+     * @param edits the files of the edit
+     * @param committed true to add the commit mark, false otherwise
+     * @return true if the journal was written, false otherwise
+     */
+    static bool writeJournal(const std::vector<writer::FileEdit>& edits, const bool& committed);
+
+    /**
+     * Retrieves the path of the edit journal.
+     *
+     * @return the path of the journal
+     */
+    static std::string getJournalPath();
+
+    /**
+     * Persists the entries of the directory of a file.
+     *
+     * @param path the path of the file
+     */
+    static void syncDirectory(const std::string& path);
+
+    /**
+     * Copies a range of the source file at the current
+     * position of the target file.
+     *
+     * @param in the source file descriptor
+     * @param out the target file descriptor
+     * @param offset the start of the range
+     * @param length the length of the range
+     * @return true if the range was copied, false otherwise
+     */
+    static bool copyRange(const int& in, const int& out, size_t offset, size_t length);
+
+    /**
+     * Writes the whole buffer at the current position of the file
+     * (retrying interrupted writes).
+     *
+     * @param out the target file descriptor
+     * @param data the buffer to write
+     * @param length the length of the buffer
+     * @return true if the buffer was written, false otherwise
+     */
+    static bool writeAll(const int& out, const char* data, size_t length);
+};
+
+#endif //PROPS_WRITER_H
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPS_THREAD_POOL_H
+#define PROPS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace thread_pool {
+    static const char MAX_WORKER_THREADS[] = "general.max_worker_threads";
+}
+
+/**
+ * Keeps a fixed set of worker threads alive executing the tasks
+ * submitted to its queue, so no threads are created per operation.
+ */
+class ThreadPool {
+
+public:
+
+    /**
+     * Static holder for the singleton instance
+     *
+     * @return the singleton instance
+     */
+    static ThreadPool& getDefault();
+
+    /**
+     * Creates the pool starting the given number of threads.
+     *
+     * @param numThreads the number of threads
+     */
+    explicit ThreadPool(const size_t& numThreads);
+
+    /**
+     * Finishes the pending tasks and joins the threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Retrieves the number of threads of the pool.
+     *
+     * @return the number of threads
+     */
+    size_t getNumThreads() const {
+        return threads_.size();
+    }
+
+    /**
+     * Queues a task for execution in the pool.
+     *
+     * @param task the task to execute
+     * @return the future result of the task
+     */
+    template <typename F>
+    std::future<typename std::result_of<F()>::type> submit(F task) {
+        typedef typename std::result_of<F()>::type result_type;
+
+        auto packagedTask = std::make_shared<std::packaged_task<result_type()>>(std::move(task));
+        std::future<result_type> future = packagedTask->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace_back([packagedTask]() { (*packagedTask)(); });
+        }
+        condition_.notify_one();
+
+        return future;
+    }
+
+private:
+
+    /**
+     * Executes the queued tasks until the pool is stopped.
+     */
+    void run();
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+};
+
+#endif //PROPS_THREAD_POOL_H
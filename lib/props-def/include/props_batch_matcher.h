@@ -0,0 +1,153 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_BATCH_MATCHER_H
+#define PROPS_BATCH_MATCHER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "props_search_options.h"
+#include "props_literal_matcher.h"
+#include "props_regex.h"
+
+namespace batch {
+
+    /**
+     * A term of the batch matched in a line
+     */
+    typedef struct BatchHit {
+        size_t term_;
+        literal::LineMatch match_;
+    } BatchHit;
+
+    /**
+     * A state of the Aho-Corasick automaton used
+     * to find partial terms.
+     */
+    typedef struct AutomatonState {
+        std::vector<std::pair<char, size_t>> next_;
+        size_t fail_;
+        std::vector<size_t> terms_;
+    } AutomatonState;
+
+    typedef std::function<std::shared_ptr<const PropsRegex>(const PropsSearchOptions&)> regex_builder;
+}
+
+/**
+ * Matches all the terms of a batch search in a single pass
+ * over every line :
+ *  - Exact literal terms are looked up in a hash table with every
+ *    candidate key (or value) delimited by the separators of the line.
+ *  - Partial literal terms are found using an Aho-Corasick automaton
+ *    and then verified as single terms would be.
+ *  - Regular expressions are tried one after another.
+ */
+class BatchMatcher {
+
+public:
+
+    /**
+     * Creates the matcher for the batch terms of the given
+     * (already amended) search options.
+     *
+     * @param searchOptions the search options
+     * @param regexBuilder compiles the regex of a single term if needed
+     */
+    BatchMatcher(const PropsSearchOptions& searchOptions, const batch::regex_builder& regexBuilder);
+
+    /**
+     * Retrieves the search options of a single term
+     *
+     * @param term the index of the term
+     * @return the search options of the term
+     */
+    const PropsSearchOptions& getTermOptions(const size_t& term) const {
+        return termOptions_[term];
+    }
+
+    /**
+     * Finds the terms matching the given line. Hits are
+     * appended in term order.
+     *
+     * @param line the start of the line
+     * @param length the length of the line (without end of line)
+     * @param hits the terms matched in the line
+     */
+    void matchLine(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const;
+
+private:
+
+    /**
+     * Finds the exact literal terms delimited by the
+     * separators of the line.
+     *
+     * @param line the start of the line
+     * @param length the length of the line
+     * @param hits the terms matched in the line
+     */
+    void matchExact(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const;
+
+    /**
+     * Finds the partial literal terms contained in the line.
+     *
+     * @param line the start of the line
+     * @param length the length of the line
+     * @param hits the terms matched in the line
+     */
+    void matchPartial(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const;
+
+    /**
+     * Tries every term regular expression in the line.
+     *
+     * @param line the start of the line
+     * @param length the length of the line
+     * @param hits the terms matched in the line
+     */
+    void matchRegex(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const;
+
+    /**
+     * Builds the Aho-Corasick automaton for the terms.
+     */
+    void buildAutomaton();
+
+    /**
+     * Retrieves the transition of the automaton from a
+     * given state (without following failure links).
+     *
+     * @param state the source state
+     * @param c the input character
+     * @param next the target state if any
+     * @return true if the transition exists, false otherwise
+     */
+    bool transition(const size_t& state, const char& c, size_t& next) const;
+
+    std::vector<PropsSearchOptions> termOptions_;
+    std::vector<std::unique_ptr<LiteralMatcher>> matchers_;
+    std::vector<std::shared_ptr<const PropsRegex>> regexes_;
+    std::unordered_map<std::string, std::vector<size_t>> exactTerms_;
+    std::vector<batch::AutomatonState> automaton_;
+    std::string separator_;
+    size_t maxTermLength_{0};
+    bool literal_{false};
+    bool caseless_{false};
+    bool partial_{false};
+    bool matchValue_{false};
+};
+
+#endif //PROPS_BATCH_MATCHER_H
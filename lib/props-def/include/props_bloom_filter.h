@@ -0,0 +1,151 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_BLOOM_FILTER_H
+#define PROPS_BLOOM_FILTER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <file_utils.h>
+#include <mapped_file.h>
+#include "props_search_options.h"
+
+namespace bloom_filter {
+    static const char ENABLE_FILTER[] = "search.enable_bloom_filter";
+    static const bool DEFAULT_ENABLE_FILTER = false;
+    static const char FILTER_EXTENSION[] = ".blm";
+    static const char FILTER_MAGIC[] = "PROPSBLM";
+    static const uint32_t FILTER_VERSION = 2;
+    static const size_t BITS_PER_KEY = 10;
+    static const uint32_t NUM_HASHES = 7;
+
+    /**
+     * Header of the filter files. Identifies the version
+     * of the properties file the filter was built from.
+     */
+    typedef struct FilterHeader {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t separatorLength_;
+        uint64_t mtime_;
+        uint64_t size_;
+        uint64_t inode_;
+        uint64_t numWords_;
+        uint32_t numHashes_;
+        uint32_t reserved_;
+    } FilterHeader;
+}
+
+/**
+ * A persistent Bloom filter of the (lowercased) keys of a properties
+ * file, where the key is the start of the line up to the first separator.
+ * Exact key searches skip the files whose filter does not contain the key.
+ * Filter files are stored in the props config folder and rebuilt lazily
+ * whenever the properties file changes (modification time, size or inode).
+ */
+class PropsBloomFilter {
+
+public:
+
+    /**
+     * Opens the filter of the given file for the given separator,
+     * building it if not found or outdated.
+     *
+     * @param fileName the absolute path to the properties file
+     * @param separator the key/value separator
+     */
+    PropsBloomFilter(const std::string& fileName, const std::string& separator);
+
+    /**
+     * Checks whether the search can be resolved using the
+     * filter i.e. exact literal key searches where the key
+     * does not contain the separator. Keys are split at the
+     * case-sensitive separator so case insensitive searches
+     * require a separator without letters.
+     *
+     * @param searchOptions the (already amended) search options
+     * @return true if the filter can be used, false otherwise
+     */
+    static bool isSupported(const PropsSearchOptions& searchOptions);
+
+    /**
+     * Checks whether the filter could be opened or built.
+     *
+     * @return true if the filter can be queried, false otherwise
+     */
+    bool isOpen() const {
+        return open_;
+    }
+
+    /**
+     * Checks whether the file may contain the given key. A negative
+     * answer is always right, a positive one may not.
+     *
+     * @param key the key
+     * @return false if the key is not in the file, true otherwise
+     */
+    bool mayContain(const std::string& key) const;
+
+private:
+
+    /**
+     * Loads the filter file if it matches the given
+     * version of the properties file.
+     *
+     * @param stamp the properties file stamp
+     * @return true if loaded, false otherwise
+     */
+    bool load(const ftl::FileStamp& stamp);
+
+    /**
+     * Builds the filter scanning the properties file and
+     * stores it (failing to store it is not an error).
+     *
+     * @param fileName the absolute path to the properties file
+     * @param stamp the properties file stamp
+     * @return true if built, false otherwise
+     */
+    bool build(const std::string& fileName, const ftl::FileStamp& stamp);
+
+    /**
+     * Adds a (lowercased) key to the filter being built.
+     *
+     * @param key the start of the key
+     * @param length the length of the key
+     */
+    void add(const char* key, const size_t& length);
+
+    /**
+     * Writes the built filter to the filter file.
+     *
+     * @param stamp the properties file stamp
+     * @return true if written, false otherwise
+     */
+    bool store(const ftl::FileStamp& stamp) const;
+
+    std::unique_ptr<MappedFile> filter_;
+    std::vector<uint64_t> builtWords_;
+    const uint64_t* words_{nullptr};
+    size_t numWords_{0};
+    uint32_t numHashes_{bloom_filter::NUM_HASHES};
+    std::string separator_;
+    std::string filterPath_;
+    bool open_{false};
+};
+
+#endif //PROPS_BLOOM_FILTER_H
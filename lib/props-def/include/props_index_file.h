@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_INDEX_FILE_H
+#define PROPS_INDEX_FILE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace index_file {
+    static const char INDEX_FOLDER[] = "index";
+
+    typedef std::pair<const void*, size_t> block;
+}
+
+/**
+ * Helpers shared by the persistent search indexes
+ */
+class IndexFile {
+
+public:
+
+    /**
+     * Removes default constructor
+     */
+    IndexFile() = delete;
+
+    /**
+     * Retrieves the path of the index file for a given properties
+     * file, stored in the index folder of the props config folder.
+     *
+     * @param fileName the absolute path to the properties file
+     * @param variant the settings the index depends on (if any)
+     * @param extension the index file extension
+     * @return the path to the index file
+     */
+    static std::string getIndexPath(const std::string& fileName, const std::string& variant, const std::string& extension);
+
+    /**
+     * Retrieves the size of a block rounded up to keep
+     * the next block aligned.
+     *
+     * @param size the block size
+     * @return the padded size
+     */
+    static size_t getPaddedSize(const size_t& size) {
+        return (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    }
+
+    /**
+     * Writes atomically the given blocks to the index file
+     * (using a temporary file renamed once written).
+     *
+     * @param indexPath the path to the index file
+     * @param blocks the consecutive blocks to write
+     * @return true if written, false otherwise
+     */
+    static bool write(const std::string& indexPath, const std::vector<index_file::block>& blocks);
+
+    /**
+     * Appends the given blocks to the end of the file
+     * (creating it if not existing).
+     *
+     * @param filePath the path to the file
+     * @param blocks the consecutive blocks to append
+     * @return true if appended, false otherwise
+     */
+    static bool append(const std::string& filePath, const std::vector<index_file::block>& blocks);
+};
+
+#endif //PROPS_INDEX_FILE_H
@@ -18,6 +18,7 @@
 #define PROPS_JSON_FORMATTER_H
 
 #include <props_formatter.h>
+#include <props_json_writer.h>
 
 class JsonPropsFormatter : public PropsFormatter {
 
@@ -30,6 +31,65 @@ class JsonPropsFormatter : public PropsFormatter {
      */
     void format(const PropsSearchResult* result, std::ostream& out) const override;
 
+    /**
+     * Formats the results of a batch search in JSON
+     * format grouped by term, appending to the given
+     * output stream.
+     *
+     * @param result the result
+     * @param out the output stream
+     */
+    void formatBatch(const PropsSearchResult* result, std::ostream& out) const;
+
+    /**
+     * Creates a sink formatting the results of a (non batch)
+     * search file by file as they are received.
+     *
+     * @param searchOptions the search options
+     * @param out the output stream
+     * @return the sink
+     */
+    std::unique_ptr<PropsResultSink> createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const override;
+
+};
+
+/**
+ * Formats the matches of every file in JSON format as soon
+ * as received. The totals are written after the files.
+ */
+class JsonResultSink : public PropsResultSink {
+
+public:
+
+    /**
+     * Creates the sink for the given output stream.
+     *
+     * @param searchOptions the search options
+     * @param out the output stream
+     */
+    JsonResultSink(PropsSearchOptions searchOptions, std::ostream& out);
+
+    /**
+     * Formats the matches found in a given file, writing
+     * the header of the results before the first file.
+     *
+     * @param fileName the name of the file
+     * @param matches the matches found in line order
+     */
+    void add(const std::string& fileName, const p_search_res::MatchRange& matches) override;
+
+    /**
+     * Completes the output once all files were received
+     * writing the totals (only if any file was received).
+     */
+    void finish() override;
+
+private:
+
+    PropsSearchOptions searchOptions_;
+    JsonWriter writer_;
+    size_t numMatches_{0};
+    size_t numFiles_{0};
 };
 
 #endif //PROPS_JSON_FORMATTER_H
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPS_JSON_WRITER_H
+#define PROPS_JSON_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <pcre_stringpiece.h>
+
+namespace json_writer {
+    static const char KEY_COMPACT_OUTPUT[] = "search.json_compact";
+    static const bool DEFAULT_COMPACT_OUTPUT = false;
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    static const size_t INDENT_SIZE = 2;
+}
+
+/**
+ * Writes JSON documents to an output stream through a
+ * large buffer escaping all the strings written. Documents
+ * are written either indented or compact.
+ */
+class JsonWriter {
+
+public:
+
+    /**
+     * Creates the writer for the given output stream.
+     *
+     * @param out the output stream
+     * @param compact true to skip the indentation, false otherwise
+     */
+    JsonWriter(std::ostream& out, const bool& compact);
+
+    /**
+     * Flushes the pending output.
+     */
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    /**
+     * Starts a new object.
+     */
+    void beginObject();
+
+    /**
+     * Ends the current object.
+     */
+    void endObject();
+
+    /**
+     * Starts a new array.
+     */
+    void beginArray();
+
+    /**
+     * Ends the current array.
+     */
+    void endArray();
+
+    /**
+     * Writes the name of the next member of the
+     * current object.
+     *
+     * @param name the name of the member
+     */
+    void key(const char* name);
+
+    /**
+     * Writes an escaped string value.
+     *
+     * @param value the value
+     */
+    void value(const pcrecpp::StringPiece& value);
+
+    /**
+     * Writes an escaped string value.
+     *
+     * @param value the value
+     */
+    void value(const char* value) {
+        this->value(pcrecpp::StringPiece(value));
+    }
+
+    /**
+     * Writes a numeric value.
+     *
+     * @param value the value
+     */
+    void value(const size_t& value);
+
+    /**
+     * Writes a boolean value.
+     *
+     * @param value the value
+     */
+    void value(const bool& value);
+
+    /**
+     * Writes the buffered output to the stream
+     * and flushes the stream.
+     */
+    void flush();
+
+private:
+
+    /**
+     * Starts a new element of the current array or
+     * object, writing the separator from the previous one.
+     */
+    void beginElement();
+
+    /**
+     * Ends the current array or object.
+     *
+     * @param close the closing character
+     */
+    void endScope(const char& close);
+
+    /**
+     * Writes a line break and the indentation of
+     * the current scope (unless compact).
+     */
+    void newLine();
+
+    /**
+     * Writes the given string escaping the characters
+     * not allowed in JSON strings.
+     *
+     * @param data the string
+     * @param size the size of the string
+     */
+    void writeEscaped(const char* data, size_t size);
+
+    /**
+     * Appends raw data to the buffer.
+     *
+     * @param data the data
+     * @param size the size of the data
+     */
+    void write(const char* data, const size_t& size);
+
+    /**
+     * Appends a raw character to the buffer.
+     *
+     * @param c the character
+     */
+    void write(const char& c) {
+        if (size_ == buffer_.size()) {
+            writeBuffer();
+        }
+        buffer_[size_++] = c;
+    }
+
+    /**
+     * Writes the buffered output to the stream.
+     */
+    void writeBuffer();
+
+    std::ostream& out_;
+    bool compact_;
+    std::vector<char> buffer_;
+    size_t size_{0};
+    std::string indent_;
+    std::vector<bool> firstElement_;
+    bool afterKey_{false};
+};
+
+#endif //PROPS_JSON_WRITER_H
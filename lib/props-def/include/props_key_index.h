@@ -0,0 +1,174 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_KEY_INDEX_H
+#define PROPS_KEY_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <file_utils.h>
+#include <mapped_file.h>
+#include "props_search_options.h"
+
+namespace key_index {
+    static const char ENABLE_INDEX[] = "search.enable_index";
+    static const bool DEFAULT_ENABLE_INDEX = false;
+    static const char INDEX_EXTENSION[] = ".idx";
+    static const char INDEX_MAGIC[] = "PROPSIDX";
+    static const uint32_t INDEX_VERSION = 1;
+
+    /**
+     * Header of the index files. Identifies the version
+     * of the properties file the index was built from.
+     */
+    typedef struct IndexHeader {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t separatorLength_;
+        uint64_t mtime_;
+        uint64_t size_;
+        uint64_t inode_;
+        uint64_t numEntries_;
+    } IndexHeader;
+
+    /**
+     * A key of the properties file. The key is the start of
+     * the line up to the first separator so it is not stored
+     * but read from the properties file itself.
+     */
+    typedef struct IndexEntry {
+        uint64_t offset_;
+        uint32_t keyLength_;
+        uint32_t lineLength_;
+    } IndexEntry;
+}
+
+/**
+ * A persistent table of the keys of a properties file sorted by
+ * key, allowing exact key lookups without scanning the file. Index
+ * files are stored in the props config folder and rebuilt lazily
+ * whenever the properties file changes (modification time, size
+ * or inode).
+ */
+class PropsKeyIndex {
+
+public:
+
+    /**
+     * Opens the index of the given file for the given separator,
+     * building it if not found or outdated.
+     *
+     * @param fileName the absolute path to the properties file
+     * @param separator the key/value separator
+     */
+    PropsKeyIndex(const std::string& fileName, const std::string& separator);
+
+    /**
+     * Checks whether the search can be resolved using the
+     * index i.e. exact case-sensitive literal key searches where
+     * the key does not contain the separator.
+     *
+     * @param searchOptions the (already amended) search options
+     * @return true if the index can be used, false otherwise
+     */
+    static bool isSupported(const PropsSearchOptions& searchOptions);
+
+    /**
+     * Checks whether the index could be opened or built.
+     *
+     * @return true if the index can be queried, false otherwise
+     */
+    bool isOpen() const {
+        return open_;
+    }
+
+    /**
+     * Finds the lines of the properties file with the given key.
+     *
+     * @param key the key to find
+     * @param entries the entries found in line order
+     */
+    void find(const std::string& key, std::vector<key_index::IndexEntry>& entries) const;
+
+    /**
+     * Retrieves the contents of the properties file.
+     *
+     * @return the contents of the properties file
+     */
+    const char* getData() const {
+        return source_->data();
+    }
+
+    /**
+     * Retrieves the mapped properties file (to keep
+     * its contents available after the index is released).
+     *
+     * @return the mapped properties file
+     */
+    const std::shared_ptr<MappedFile>& getSource() const {
+        return source_;
+    }
+
+private:
+
+    /**
+     * Loads the index file if it matches the given
+     * version of the properties file.
+     *
+     * @param stamp the properties file stamp
+     * @return true if loaded, false otherwise
+     */
+    bool load(const ftl::FileStamp& stamp);
+
+    /**
+     * Builds the index scanning the properties file and
+     * stores it (failing to store it is not an error).
+     *
+     * @param stamp the properties file stamp
+     */
+    void build(const ftl::FileStamp& stamp);
+
+    /**
+     * Writes the built index to the index file.
+     *
+     * @param stamp the properties file stamp
+     * @return true if written, false otherwise
+     */
+    bool store(const ftl::FileStamp& stamp) const;
+
+    /**
+     * Compares the key of the given entry with a key.
+     *
+     * @param entry the index entry
+     * @param key the key
+     * @param keyLength the length of the key
+     * @return <0, 0 or >0 if the entry key is lower, equal or greater
+     */
+    int compare(const key_index::IndexEntry& entry, const char* key, const size_t& keyLength) const;
+
+    std::shared_ptr<MappedFile> source_;
+    std::unique_ptr<MappedFile> index_;
+    std::vector<key_index::IndexEntry> builtEntries_;
+    const key_index::IndexEntry* entries_{nullptr};
+    size_t numEntries_{0};
+    std::string separator_;
+    std::string indexPath_;
+    bool open_{false};
+};
+
+#endif //PROPS_KEY_INDEX_H
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_LITERAL_MATCHER_H
+#define PROPS_LITERAL_MATCHER_H
+
+#include <string>
+#include "props_search_options.h"
+
+namespace literal {
+
+    /**
+     * Positions of the key and value matched in a line
+     */
+    typedef struct LineMatch {
+        size_t keyPos_;
+        size_t keyLength_;
+        size_t valuePos_;
+        size_t valueLength_;
+    } LineMatch;
+
+    /**
+     * Converts an ASCII character to lower case (same
+     * as PCRE caseless matching with default tables).
+     *
+     * @param c the character
+     * @return the lowercase character
+     */
+    inline char toLower(const char& c) {
+        return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    /**
+     * Converts an ASCII string to lower case.
+     *
+     * @param input the input string
+     * @return the lowercase string
+     */
+    std::string toLower(const std::string& input);
+}
+
+/**
+ * Matches non-regex search terms without using PCRE. The matches
+ * found are the same (including the captured key/value positions) than
+ * the ones of the regular expression built by the reader for the term.
+ */
+class LiteralMatcher {
+
+public:
+
+    /**
+     * Creates the matcher for the given (already amended) search options.
+     *
+     * @param searchOptions the search options
+     */
+    explicit LiteralMatcher(const PropsSearchOptions& searchOptions);
+
+    /**
+     * Checks whether the given search options can be resolved
+     * using a literal matcher.
+     *
+     * @param searchOptions the search options
+     * @return true if a literal matcher can be used, false otherwise
+     */
+    static bool isSupported(const PropsSearchOptions& searchOptions);
+
+    /**
+     * Finds the next position in the buffer where the line
+     * containing it may match.
+     *
+     * @param begin the start of the buffer
+     * @param end the end of the buffer
+     * @return the candidate position or null if none found
+     */
+    const char* findCandidate(const char* begin, const char* end) const;
+
+    /**
+     * Tries to match a single line.
+     *
+     * @param line the start of the line
+     * @param length the length of the line (without end of line)
+     * @param match the positions of the key/value matched
+     * @return true if the line matches, false otherwise
+     */
+    bool matchLine(const char* line, size_t length, literal::LineMatch& match) const;
+
+private:
+
+    /**
+     * Finds the first occurrence of the needle in the buffer.
+     *
+     * @param begin the start of the buffer
+     * @param end the end of the buffer
+     * @param needle the text to find
+     * @return the position of the needle or null if not found
+     */
+    const char* find(const char* begin, const char* end, const std::string& needle) const;
+
+    /**
+     * Finds the last occurrence of the needle starting before
+     * the given limit.
+     *
+     * @param begin the start of the buffer
+     * @param limit the last allowed start position (inclusive)
+     * @param needle the text to find
+     * @return the position of the needle or null if not found
+     */
+    const char* rfind(const char* begin, const char* limit, const std::string& needle) const;
+
+    /**
+     * Compares the given text with the needle.
+     *
+     * @param text the text to compare
+     * @param needle the needle
+     * @return true if equal, false otherwise
+     */
+    bool equals(const char* text, const std::string& needle) const;
+
+    std::string term_;
+    std::string separator_;
+    std::string probe_;
+    bool caseless_;
+    bool partial_;
+    bool matchValue_;
+};
+
+#endif //PROPS_LITERAL_MATCHER_H
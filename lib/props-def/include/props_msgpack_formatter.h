@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef PROPS_MSGPACK_FORMATTER_H
+#define PROPS_MSGPACK_FORMATTER_H
+
+#include <props_formatter.h>
+#include <props_msgpack_writer.h>
+
+class MsgPackPropsFormatter : public PropsFormatter {
+
+    /**
+     * Formats the given result as a sequence of MessagePack
+     * maps (one per file) appending to the given output stream.
+     *
+     * @param result the result
+     * @param out the output stream
+     */
+    void format(const PropsSearchResult* result, std::ostream& out) const override;
+
+    /**
+     * Creates a sink formatting the results of a (non batch)
+     * search file by file as they are received.
+     *
+     * @param searchOptions the search options
+     * @param out the output stream
+     * @return the sink
+     */
+    std::unique_ptr<PropsResultSink> createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const override;
+
+};
+
+/**
+ * Writes the matches of every file received as a MessagePack
+ * map holding the file name, the batch term (if any) and the
+ * array of matches, so the output can be consumed file by file.
+ */
+class MsgPackResultSink : public PropsResultSink {
+
+public:
+
+    /**
+     * Creates the sink for the given output stream. The search
+     * options are amended by the search before any match is
+     * received (e.g. the default separator).
+     *
+     * @param searchOptions the search options
+     * @param out the output stream
+     */
+    MsgPackResultSink(const PropsSearchOptions& searchOptions, std::ostream& out) : searchOptions_(searchOptions), writer_(out) {}
+
+    /**
+     * Writes the matches found in a given file.
+     *
+     * @param fileName the name of the file
+     * @param matches the matches found (in line order unless their line numbers are set)
+     */
+    void add(const std::string& fileName, const p_search_res::MatchRange& matches) override;
+
+    /**
+     * Completes the output once all files were received.
+     */
+    void finish() override;
+
+    /**
+     * Sets the batch term of the next matches received.
+     *
+     * @param term the batch term (or null if none)
+     */
+    void setTerm(const std::string* term) {
+        term_ = term;
+    }
+
+    /**
+     * Sets the line numbers of the next matches received
+     * (or null to count them, if received in line order).
+     *
+     * @param lineNumbers the line numbers of the matches
+     */
+    void setLineNumbers(const size_t* lineNumbers) {
+        lineNumbers_ = lineNumbers;
+    }
+
+private:
+
+    const PropsSearchOptions& searchOptions_;
+    MsgPackWriter writer_;
+    const std::string* term_{nullptr};
+    const size_t* lineNumbers_{nullptr};
+};
+
+#endif //PROPS_MSGPACK_FORMATTER_H
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef PROPS_MSGPACK_WRITER_H
+#define PROPS_MSGPACK_WRITER_H
+
+#include <ostream>
+#include <vector>
+#include <cstdint>
+#include <pcre_stringpiece.h>
+
+namespace msgpack_writer {
+    static const size_t BUFFER_SIZE = 64 * 1024;
+}
+
+/**
+ * Writes MessagePack encoded values to an output stream
+ * through a large buffer. Maps and arrays are written
+ * with their number of elements upfront and strings as
+ * raw length prefixed bytes, so consumers can reference
+ * them in place without copying.
+ */
+class MsgPackWriter {
+
+public:
+
+    /**
+     * Creates the writer for the given output stream.
+     *
+     * @param out the output stream
+     */
+    explicit MsgPackWriter(std::ostream& out);
+
+    /**
+     * Flushes the pending output.
+     */
+    ~MsgPackWriter();
+
+    MsgPackWriter(const MsgPackWriter&) = delete;
+    MsgPackWriter& operator=(const MsgPackWriter&) = delete;
+
+    /**
+     * Starts a new map (followed by its keys and values).
+     *
+     * @param size the number of entries of the map
+     */
+    void beginMap(const size_t& size);
+
+    /**
+     * Starts a new array (followed by its elements).
+     *
+     * @param size the number of elements of the array
+     */
+    void beginArray(const size_t& size);
+
+    /**
+     * Writes a string value.
+     *
+     * @param value the value
+     */
+    void value(const pcrecpp::StringPiece& value);
+
+    /**
+     * Writes a string value.
+     *
+     * @param value the value
+     */
+    void value(const char* value) {
+        this->value(pcrecpp::StringPiece(value));
+    }
+
+    /**
+     * Writes an unsigned integer value using the
+     * smallest encoding available.
+     *
+     * @param value the value
+     */
+    void value(const size_t& value);
+
+    /**
+     * Writes a boolean value.
+     *
+     * @param value the value
+     */
+    void value(const bool& value);
+
+    /**
+     * Writes the buffered output to the stream
+     * and flushes the stream.
+     */
+    void flush();
+
+private:
+
+    /**
+     * Writes a type marker followed by a big endian
+     * length or value of the given number of bytes.
+     *
+     * @param marker the type marker
+     * @param value the length or value
+     * @param bytes the number of bytes of the value
+     */
+    void writeHeader(const uint8_t& marker, const uint64_t& value, const size_t& bytes);
+
+    /**
+     * Writes a container header, using the fixed format
+     * when possible.
+     *
+     * @param fixMarker the marker of the fixed format
+     * @param marker16 the marker of the 16 bits format
+     * @param size the number of elements
+     */
+    void writeContainer(const uint8_t& fixMarker, const uint8_t& marker16, const size_t& size);
+
+    /**
+     * Appends raw data to the buffer.
+     *
+     * @param data the data
+     * @param size the size of the data
+     */
+    void write(const char* data, const size_t& size);
+
+    /**
+     * Appends a raw byte to the buffer.
+     *
+     * @param c the byte
+     */
+    void write(const uint8_t& c) {
+        if (size_ == buffer_.size()) {
+            writeBuffer();
+        }
+        buffer_[size_++] = static_cast<char>(c);
+    }
+
+    /**
+     * Writes the buffered output to the stream.
+     */
+    void writeBuffer();
+
+    std::ostream& out_;
+    std::vector<char> buffer_;
+    size_t size_{0};
+};
+
+#endif //PROPS_MSGPACK_WRITER_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_REGEX_H
+#define PROPS_REGEX_H
+
+#include <string>
+#include <pcre.h>
+#include <pcrecpp.h>
+
+/**
+ * A compiled regular expression used to match
+ * the lines of the properties files. Patterns are
+ * JIT compiled whenever the PCRE library supports it.
+ */
+class PropsRegex {
+
+public:
+
+    /**
+     * Compiles the given pattern.
+     *
+     * @param pattern the regular expression
+     * @param caseless the flag enabling case insensitive matching
+     * @param useJit the flag enabling JIT compilation (if supported)
+     * @throws ExecutionException if the pattern is not valid
+     */
+    PropsRegex(const std::string& pattern, bool caseless, bool useJit = true);
+
+    /**
+     * Releases the compiled pattern.
+     */
+    ~PropsRegex();
+
+    PropsRegex(const PropsRegex&) = delete;
+    PropsRegex& operator=(const PropsRegex&) = delete;
+
+    /**
+     * Tries to match the pattern in the given text retrieving
+     * the first two capturing groups.
+     *
+     * @param text the text to match
+     * @param key the first group matched
+     * @param value the second group matched
+     * @return true if the text matches, false otherwise
+     */
+    bool match(const pcrecpp::StringPiece& text, pcrecpp::StringPiece* key, pcrecpp::StringPiece* value) const;
+
+    /**
+     * Retrieves the number of capturing groups of the pattern.
+     *
+     * @return the number of capturing groups
+     */
+    int getNumberOfCapturingGroups() const {
+        return captureCount_;
+    }
+
+    /**
+     * Checks whether the pattern was JIT compiled.
+     *
+     * @return true if JIT compiled, false otherwise
+     */
+    bool isJit() const {
+        return jit_;
+    }
+
+private:
+
+    pcre* code_{nullptr};
+    pcre_extra* extra_{nullptr};
+    int captureCount_{0};
+    bool jit_{false};
+};
+
+#endif //PROPS_REGEX_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_REGEX_CACHE_H
+#define PROPS_REGEX_CACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "props_regex.h"
+
+namespace regex_cache {
+    static const char CACHE_SIZE[] = "search.regex_cache_size";
+    static const long DEFAULT_CACHE_SIZE = 32;
+}
+
+/**
+ * Keeps the most recently used compiled patterns so that
+ * repeated searches skip the compilation.
+ */
+class PropsRegexCache {
+
+public:
+
+    /**
+     * Static holder for the singleton instance
+     *
+     * @return the singleton instance
+     */
+    static PropsRegexCache& getDefault() {
+        static PropsRegexCache instance;
+        return instance;
+    }
+
+    /**
+     * Retrieves the compiled pattern for the given search
+     * terms, compiling it on a cache miss.
+     *
+     * @param pattern the regular expression
+     * @param caseless the flag enabling case insensitive matching
+     * @param separator the key/value separator the pattern was built with
+     * @param partial the partial match flag the pattern was built with
+     * @return the compiled pattern
+     * @throws ExecutionException if the pattern is not valid
+     */
+    std::shared_ptr<const PropsRegex> get(const std::string& pattern, bool caseless, const std::string& separator, bool partial);
+
+private:
+
+    typedef std::pair<std::string, std::shared_ptr<const PropsRegex>> entry;
+
+    PropsRegexCache();
+
+    size_t capacity_;
+    std::list<entry> entries_;
+    std::unordered_map<std::string, std::list<entry>::iterator> index_;
+    std::mutex mutex_;
+};
+
+#endif //PROPS_REGEX_CACHE_H
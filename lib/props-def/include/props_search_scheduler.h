@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPS_SEARCH_SCHEDULER_H
+#define PROPS_SEARCH_SCHEDULER_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace scheduler {
+
+    /**
+     * A byte range of a file to search. The lines
+     * belong to the range containing their first byte.
+     */
+    typedef struct SearchTask {
+        size_t fileIndex_;
+        size_t rangeIndex_;
+        size_t begin_;
+        size_t end_;
+    } SearchTask;
+}
+
+/**
+ * Hands out search tasks to a fixed number of workers. Every
+ * worker owns a queue of tasks (sorted largest first or kept in
+ * the given order) and steals from the queues of the other
+ * workers once its own is empty.
+ */
+class SearchScheduler {
+
+public:
+
+    /**
+     * Creates the scheduler for the given number of workers.
+     *
+     * @param numWorkers the number of workers
+     */
+    explicit SearchScheduler(const size_t& numWorkers);
+
+    /**
+     * Distributes the tasks among the worker queues, largest first
+     * or keeping their order (so tasks are taken in the given order).
+     *
+     * @param tasks the tasks to distribute
+     * @param largestFirst the flag to sort the tasks largest first
+     */
+    void schedule(std::vector<scheduler::SearchTask> tasks, const bool& largestFirst);
+
+    /**
+     * Assigns a queue to the calling worker.
+     *
+     * @return the worker identifier
+     */
+    size_t registerWorker();
+
+    /**
+     * Retrieves the next task of the worker, stealing
+     * it from another worker if its queue is empty.
+     *
+     * @param worker the worker identifier
+     * @param task the next task
+     * @return true if a task was found, false if all queues are empty
+     */
+    bool next(const size_t& worker, scheduler::SearchTask& task);
+
+private:
+
+    typedef struct WorkerQueue {
+        std::mutex mutex_;
+        std::deque<scheduler::SearchTask> tasks_;
+    } WorkerQueue;
+
+    /**
+     * Takes the first task of the given queue.
+     *
+     * @param queue the queue
+     * @param task the task taken
+     * @return true if the queue had any task, false otherwise
+     */
+    static bool take(WorkerQueue& queue, scheduler::SearchTask& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::atomic<size_t> nextWorker_;
+};
+
+#endif //PROPS_SEARCH_SCHEDULER_H
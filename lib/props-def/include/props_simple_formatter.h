@@ -18,6 +18,11 @@
 #define PROPS_SIMPLE_FORMATTER_H
 
 #include <props_formatter.h>
+#include <string>
+
+namespace simple_formatter {
+    static const size_t BUFFER_SIZE = 64 * 1024;
+}
 
 class SimplePropsFormatter : public PropsFormatter {
 
@@ -30,6 +35,74 @@ class SimplePropsFormatter : public PropsFormatter {
      */
     void format(const PropsSearchResult* result, std::ostream& out) const override;
 
+    /**
+     * Creates a sink formatting the results of a (non batch)
+     * search file by file as they are received.
+     *
+     * @param searchOptions the search options
+     * @param out the output stream
+     * @return the sink
+     */
+    std::unique_ptr<PropsResultSink> createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const override;
+
+};
+
+/**
+ * Formats the matches of every file as soon as received. The
+ * style escape sequences are computed once and every line is
+ * written as plain spans into a buffer flushed per file.
+ */
+class SimpleResultSink : public PropsResultSink {
+
+public:
+
+    /**
+     * Creates the sink for the given output stream.
+     *
+     * @param enableHighlight the flag to highlight the matched term
+     * @param matchValue the flag to highlight the value instead of the key
+     * @param out the output stream
+     */
+    SimpleResultSink(const bool& enableHighlight, const bool& matchValue, std::ostream& out);
+
+    /**
+     * Formats the matches found in a given file.
+     *
+     * @param fileName the name of the file
+     * @param matches the matches found in line order
+     */
+    void add(const std::string& fileName, const p_search_res::MatchRange& matches) override;
+
+    /**
+     * Completes the output once all files were received.
+     */
+    void finish() override;
+
+private:
+
+    /**
+     * Appends the given line to the buffer highlighting
+     * the matched term.
+     *
+     * @param line the line
+     * @param term the matched term (inside the line)
+     */
+    void writeLine(const pcrecpp::StringPiece& line, const pcrecpp::StringPiece& term);
+
+    /**
+     * Writes the buffered output to the stream.
+     */
+    void writeBuffer();
+
+    bool enableHighlight_;
+    bool matchValue_;
+    std::ostream& out_;
+    std::string buffer_;
+    std::string fileStyle_;
+    std::string lineStyle_;
+    std::string resetStyle_;
+    std::string highlightStyle_;
+    std::string highlightReset_;
 };
 
 #endif //PROPS_SIMPLE_FORMATTER_H
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROPS_TRIGRAM_INDEX_H
+#define PROPS_TRIGRAM_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <file_utils.h>
+#include <mapped_file.h>
+#include "props_search_options.h"
+
+namespace trigram_index {
+    static const char ENABLE_INDEX[] = "search.enable_trigram_index";
+    static const bool DEFAULT_ENABLE_INDEX = false;
+    static const char MAX_MEMORY[] = "search.trigram_index_max_memory";
+    static const size_t DEFAULT_MAX_MEMORY = 256 * 1024 * 1024;
+    static const char INDEX_EXTENSION[] = ".tri";
+    static const char INDEX_MAGIC[] = "PROPSTRI";
+    static const uint32_t INDEX_VERSION = 1;
+    static const size_t TRIGRAM_SIZE = 3;
+
+    /**
+     * Header of the trigram index files. Identifies the version
+     * of the properties file the index was built from.
+     */
+    typedef struct IndexHeader {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t reserved_;
+        uint64_t mtime_;
+        uint64_t size_;
+        uint64_t inode_;
+        uint64_t numLines_;
+        uint64_t numTrigrams_;
+        uint64_t numPostings_;
+    } IndexHeader;
+
+    /**
+     * A (non commented) line of the properties file
+     */
+    typedef struct IndexLine {
+        uint64_t offset_;
+        uint32_t length_;
+        uint32_t reserved_;
+    } IndexLine;
+
+    /**
+     * A trigram and the position of the sorted list
+     * of lines containing it in the postings.
+     */
+    typedef struct TrigramEntry {
+        uint32_t trigram_;
+        uint32_t count_;
+        uint64_t start_;
+    } TrigramEntry;
+}
+
+/**
+ * A persistent trigram index of the lines of a properties file.
+ * Every (lowercased) trigram of a line maps to the sorted list of lines
+ * containing it, so the lines including some given literals are found
+ * intersecting the lists of their trigrams. The candidate lines are then
+ * confirmed by the regular matchers. Index files are stored in the
+ * props config folder and rebuilt lazily whenever the properties file
+ * changes (modification time, size or inode).
+ */
+class PropsTrigramIndex {
+
+public:
+
+    /**
+     * Opens the trigram index of the given file,
+     * building it if not found or outdated.
+     *
+     * @param fileName the absolute path to the properties file
+     */
+    explicit PropsTrigramIndex(const std::string& fileName);
+
+    /**
+     * Retrieves the (lowercased) literals every line matching the
+     * search must contain. Only literals long enough to have trigrams
+     * are retrieved, so no literals means the index cannot be used.
+     *
+     * @param searchOptions the (already amended) search options
+     * @param literals the required literals
+     */
+    static void getRequiredLiterals(const PropsSearchOptions& searchOptions, std::vector<std::string>& literals);
+
+    /**
+     * Checks whether the index could be opened or built.
+     *
+     * @return true if the index can be queried, false otherwise
+     */
+    bool isOpen() const {
+        return open_;
+    }
+
+    /**
+     * Finds the lines containing all trigrams of the given literals.
+     *
+     * @param literals the required literals
+     * @param lines the candidate lines in line order
+     */
+    void find(const std::vector<std::string>& literals, std::vector<trigram_index::IndexLine>& lines) const;
+
+    /**
+     * Retrieves the contents of the properties file.
+     *
+     * @return the contents of the properties file
+     */
+    const char* getData() const {
+        return source_->data();
+    }
+
+    /**
+     * Retrieves the mapped properties file (to keep
+     * its contents available after the index is released).
+     *
+     * @return the mapped properties file
+     */
+    const std::shared_ptr<MappedFile>& getSource() const {
+        return source_;
+    }
+
+private:
+
+    /**
+     * Extracts the literals any match of the given regular expression
+     * must contain. Alternations and unknown constructs are not analyzed.
+     *
+     * @param regex the regular expression
+     * @param literals the required literals
+     * @return true if the expression could be analyzed, false otherwise
+     */
+    static bool extractLiterals(const std::string& regex, std::vector<std::string>& literals);
+
+    /**
+     * Loads the index file if it matches the given
+     * version of the properties file.
+     *
+     * @param stamp the properties file stamp
+     * @return true if loaded, false otherwise
+     */
+    bool load(const ftl::FileStamp& stamp);
+
+    /**
+     * Builds the index scanning the properties file and stores it
+     * (failing to store it is not an error). The postings are counted
+     * first and then filled in place so no intermediate list of
+     * trigram/line pairs is kept. Indexes exceeding the memory limit
+     * are not built (the file is then scanned).
+     *
+     * @param stamp the properties file stamp
+     * @return true if built, false otherwise
+     */
+    bool build(const ftl::FileStamp& stamp);
+
+    /**
+     * Writes the built index to the index file.
+     *
+     * @param stamp the properties file stamp
+     * @return true if written, false otherwise
+     */
+    bool store(const ftl::FileStamp& stamp) const;
+
+    /**
+     * Finds the entry of the given trigram.
+     *
+     * @param trigram the trigram
+     * @return the entry or null if no line contains it
+     */
+    const trigram_index::TrigramEntry* findTrigram(const uint32_t& trigram) const;
+
+    std::shared_ptr<MappedFile> source_;
+    std::unique_ptr<MappedFile> index_;
+    std::vector<trigram_index::IndexLine> builtLines_;
+    std::vector<trigram_index::TrigramEntry> builtTrigrams_;
+    std::vector<uint32_t> builtPostings_;
+    const trigram_index::IndexLine* lines_{nullptr};
+    const trigram_index::TrigramEntry* trigrams_{nullptr};
+    const uint32_t* postings_{nullptr};
+    size_t numLines_{0};
+    size_t numTrigrams_{0};
+    size_t numPostings_{0};
+    std::string indexPath_;
+    bool open_{false};
+};
+
+#endif //PROPS_TRIGRAM_INDEX_H
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_batch_matcher.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+/**
+ * Namespace for constants
+ */
+namespace batch {
+    static const size_t ROOT_STATE = 0;
+}
+
+/**
+ * Creates the matcher for the batch terms of the given
+ * (already amended) search options.
+ *
+ * @param searchOptions the search options
+ * @param regexBuilder compiles the regex of a single term if needed
+ */
+BatchMatcher::BatchMatcher(const PropsSearchOptions& searchOptions, const batch::regex_builder& regexBuilder) {
+    caseless_   = (searchOptions.getCaseSensitive() == global_options::NO_OPT);
+    partial_    = (searchOptions.getPartialMatch() == global_options::USE_OPT);
+    matchValue_ = searchOptions.isMatchValue();
+    separator_  = caseless_ ? literal::toLower(searchOptions.getSeparator()) : searchOptions.getSeparator();
+
+    // Every term is searched (and replaced) as a single search would do
+    const std::vector<std::string>& keys = searchOptions.getBatchKeys();
+    const std::vector<std::string>& replacements = searchOptions.getBatchReplacements();
+    for (size_t i = 0; i < keys.size(); i++) {
+        PropsSearchOptions termOptions = searchOptions;
+        termOptions.setKey(keys[i]);
+        termOptions.setBatchKeys({});
+        termOptions.setBatchReplacements({});
+        if (i < replacements.size()) {
+            termOptions.setReplacement(replacements[i]);
+        }
+        termOptions_.push_back(termOptions);
+    }
+
+    literal_ = std::all_of(termOptions_.begin(), termOptions_.end(), [](const PropsSearchOptions& options) {
+        return LiteralMatcher::isSupported(options);
+    });
+
+    for (size_t i = 0; i < termOptions_.size(); i++) {
+        if (literal_) {
+            const std::string& term = termOptions_[i].getKey();
+            matchers_.emplace_back(new LiteralMatcher(termOptions_[i]));
+            exactTerms_[caseless_ ? literal::toLower(term) : term].push_back(i);
+            maxTermLength_ = std::max(maxTermLength_, term.size());
+        } else {
+            regexes_.push_back(regexBuilder(termOptions_[i]));
+        }
+    }
+
+    if (literal_ && partial_) {
+        buildAutomaton();
+    }
+}
+
+/**
+ * Finds the terms matching the given line. Hits are
+ * appended in term order.
+ *
+ * @param line the start of the line
+ * @param length the length of the line (without end of line)
+ * @param hits the terms matched in the line
+ */
+void BatchMatcher::matchLine(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const {
+    auto first = hits.size();
+
+    if (!literal_) {
+        matchRegex(line, length, hits);
+    } else if (partial_) {
+        matchPartial(line, length, hits);
+    } else {
+        matchExact(line, length, hits);
+    }
+
+    std::sort(hits.begin() + first, hits.end(), [](const batch::BatchHit& a, const batch::BatchHit& b) {
+        return a.term_ < b.term_;
+    });
+}
+
+/**
+ * Finds the exact literal terms delimited by the
+ * separators of the line.
+ *
+ * @param line the start of the line
+ * @param length the length of the line
+ * @param hits the terms matched in the line
+ */
+void BatchMatcher::matchExact(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const {
+    const size_t sepSize = separator_.size();
+
+    // The line needs a non empty key, the separator and a non empty value
+    if (length < sepSize + 2) {
+        return;
+    }
+
+    // Only separators close enough to the start (or end) can delimit a term
+    size_t last = length - sepSize - 1;
+    size_t first = 1;
+    if (!matchValue_) {
+        last = std::min(last, maxTermLength_);
+    } else if (length - sepSize > maxTermLength_) {
+        first = std::max(first, length - sepSize - maxTermLength_);
+    }
+
+    std::string probe;
+    for (size_t pos = first; pos <= last; pos++) {
+        bool isSeparator = true;
+        for (size_t i = 0; isSeparator && (i < sepSize); i++) {
+            isSeparator = ((caseless_ ? literal::toLower(line[pos + i]) : line[pos + i]) == separator_[i]);
+        }
+
+        if (isSeparator) {
+            size_t valuePos = pos + sepSize;
+            if (!matchValue_) {
+                probe.assign(line, pos);
+            } else {
+                probe.assign(line + valuePos, length - valuePos);
+            }
+            if (caseless_) {
+                std::transform(probe.begin(), probe.end(), probe.begin(), [](const char& c) { return literal::toLower(c); });
+            }
+
+            auto it = exactTerms_.find(probe);
+            if (it != exactTerms_.end()) {
+                for (auto& term : it->second) {
+                    hits.push_back(batch::BatchHit{term, literal::LineMatch{0, pos, valuePos, length - valuePos}});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Finds the partial literal terms contained in the line.
+ *
+ * @param line the start of the line
+ * @param length the length of the line
+ * @param hits the terms matched in the line
+ */
+void BatchMatcher::matchPartial(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const {
+    std::vector<size_t> found;
+    size_t state = batch::ROOT_STATE;
+
+    for (size_t i = 0; i < length; i++) {
+        char c = caseless_ ? literal::toLower(line[i]) : line[i];
+        size_t next = batch::ROOT_STATE;
+        while (!transition(state, c, next) && (state != batch::ROOT_STATE)) {
+            state = automaton_[state].fail_;
+        }
+        state = next;
+        const auto& terms = automaton_[state].terms_;
+        found.insert(found.end(), terms.begin(), terms.end());
+    }
+
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    // Confirm the term is placed where a single search would find it
+    literal::LineMatch lineMatch{};
+    for (auto& term : found) {
+        if (matchers_[term]->matchLine(line, length, lineMatch)) {
+            hits.push_back(batch::BatchHit{term, lineMatch});
+        }
+    }
+}
+
+/**
+ * Tries every term regular expression in the line.
+ *
+ * @param line the start of the line
+ * @param length the length of the line
+ * @param hits the terms matched in the line
+ */
+void BatchMatcher::matchRegex(const char* line, size_t length, std::vector<batch::BatchHit>& hits) const {
+    pcrecpp::StringPiece text(line, static_cast<int>(length));
+    pcrecpp::StringPiece value_k;
+    pcrecpp::StringPiece value_r;
+
+    for (size_t term = 0; term < regexes_.size(); term++) {
+        if (regexes_[term]->match(text, &value_k, &value_r)) {
+            hits.push_back(batch::BatchHit{term, literal::LineMatch{static_cast<size_t>(value_k.data() - line),
+                                                                    static_cast<size_t>(value_k.size()),
+                                                                    static_cast<size_t>(value_r.data() - line),
+                                                                    static_cast<size_t>(value_r.size())}});
+        }
+    }
+}
+
+/**
+ * Builds the Aho-Corasick automaton for the terms.
+ */
+void BatchMatcher::buildAutomaton() {
+    automaton_.push_back(batch::AutomatonState{{}, batch::ROOT_STATE, {}});
+
+    // Build the trie
+    for (size_t term = 0; term < termOptions_.size(); term++) {
+        const std::string& key = termOptions_[term].getKey();
+        size_t state = batch::ROOT_STATE;
+        for (auto c : key) {
+            c = caseless_ ? literal::toLower(c) : c;
+            size_t next;
+            if (!transition(state, c, next)) {
+                next = automaton_.size();
+                automaton_.push_back(batch::AutomatonState{{}, batch::ROOT_STATE, {}});
+                auto& transitions = automaton_[state].next_;
+                auto it = std::lower_bound(transitions.begin(), transitions.end(), std::make_pair(c, size_t{0}));
+                transitions.insert(it, std::make_pair(c, next));
+            }
+            state = next;
+        }
+        automaton_[state].terms_.push_back(term);
+    }
+
+    // Compute the failure links breadth first
+    std::deque<size_t> pending;
+    for (auto& transition : automaton_[batch::ROOT_STATE].next_) {
+        pending.push_back(transition.second);
+    }
+
+    while (!pending.empty()) {
+        size_t state = pending.front();
+        pending.pop_front();
+
+        for (auto& edge : automaton_[state].next_) {
+            size_t child = edge.second;
+            size_t fail = automaton_[state].fail_;
+            size_t next = batch::ROOT_STATE;
+            while (!transition(fail, edge.first, next) && (fail != batch::ROOT_STATE)) {
+                fail = automaton_[fail].fail_;
+            }
+            automaton_[child].fail_ = next;
+
+            // Terms ending at the failure state end here as well
+            const auto& inherited = automaton_[next].terms_;
+            automaton_[child].terms_.insert(automaton_[child].terms_.end(), inherited.begin(), inherited.end());
+            pending.push_back(child);
+        }
+    }
+}
+
+/**
+ * Retrieves the transition of the automaton from a
+ * given state (without following failure links).
+ *
+ * @param state the source state
+ * @param c the input character
+ * @param next the target state if any
+ * @return true if the transition exists, false otherwise
+ */
+bool BatchMatcher::transition(const size_t& state, const char& c, size_t& next) const {
+    const auto& transitions = automaton_[state].next_;
+    auto it = std::lower_bound(transitions.begin(), transitions.end(), std::make_pair(c, size_t{0}));
+    bool found = (it != transitions.end()) && (it->first == c);
+    if (found) {
+        next = it->second;
+    }
+    return found;
+}
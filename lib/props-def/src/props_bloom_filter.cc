@@ -0,0 +1,260 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_bloom_filter.h"
+#include <algorithm>
+#include <cstring>
+#include <props_config.h>
+#include "props_index_file.h"
+#include "props_literal_matcher.h"
+
+// Prototypes for local functions
+uint64_t hash_key(const char* key, const size_t& length, uint64_t seed);
+bool has_letters(const std::string& input);
+
+/**
+ * Namespace for constants
+ */
+namespace bloom_filter {
+    static const uint64_t FIRST_SEED = 14695981039346656037ULL;
+    static const uint64_t SECOND_SEED = 0x9E3779B97F4A7C15ULL;
+    static const size_t BITS_PER_WORD = 64;
+}
+
+/**
+ * Hashes the given key (FNV-1a).
+ *
+ * @param key the start of the key
+ * @param length the length of the key
+ * @param seed the initial hash value
+ * @return the hash of the key
+ */
+uint64_t hash_key(const char* key, const size_t& length, uint64_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        seed ^= static_cast<unsigned char>(key[i]);
+        seed *= 1099511628211ULL;
+    }
+    return seed;
+}
+
+/**
+ * Checks whether the given string contains ASCII letters.
+ *
+ * @param input the input string
+ * @return true if any letter found, false otherwise
+ */
+bool has_letters(const std::string& input) {
+    return std::any_of(input.begin(), input.end(), [](const char& c) {
+        return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+    });
+}
+
+/**
+ * Opens the filter of the given file for the given separator,
+ * building it if not found or outdated.
+ *
+ * @param fileName the absolute path to the properties file
+ * @param separator the key/value separator
+ */
+PropsBloomFilter::PropsBloomFilter(const std::string& fileName, const std::string& separator) : separator_(separator) {
+    ftl::FileStamp stamp{};
+
+    if (FileUtils::getFileStamp(fileName, stamp)) {
+        filterPath_ = IndexFile::getIndexPath(fileName, separator_, bloom_filter::FILTER_EXTENSION);
+        open_ = load(stamp) || build(fileName, stamp);
+    }
+}
+
+/**
+ * Checks whether the search can be resolved using the
+ * filter i.e. exact literal key searches where the key
+ * does not contain the separator. Keys are split at the
+ * case-sensitive separator so case insensitive searches
+ * require a separator without letters.
+ *
+ * @param searchOptions the (already amended) search options
+ * @return true if the filter can be used, false otherwise
+ */
+bool PropsBloomFilter::isSupported(const PropsSearchOptions& searchOptions) {
+    const std::string& key = searchOptions.getKey();
+    const std::string& separator = searchOptions.getSeparator();
+
+    return PropsConfig::getDefault().getValue<bool>(bloom_filter::ENABLE_FILTER, bloom_filter::DEFAULT_ENABLE_FILTER)
+           && !searchOptions.isBatch() && !searchOptions.isMatchValue()
+           && (searchOptions.getPartialMatch() == global_options::NO_OPT)
+           && ((searchOptions.getCaseSensitive() == global_options::USE_OPT) || !has_letters(separator))
+           && LiteralMatcher::isSupported(searchOptions)
+           && ((key + separator).find(separator) == key.size());
+}
+
+/**
+ * Checks whether the file may contain the given key. A negative
+ * answer is always right, a positive one may not.
+ *
+ * @param key the key
+ * @return false if the key is not in the file, true otherwise
+ */
+bool PropsBloomFilter::mayContain(const std::string& key) const {
+    bool contained = (numWords_ > 0);
+
+    if (contained) {
+        const std::string& lowerKey = literal::toLower(key);
+        uint64_t h1 = hash_key(lowerKey.data(), lowerKey.size(), bloom_filter::FIRST_SEED);
+        uint64_t h2 = hash_key(lowerKey.data(), lowerKey.size(), bloom_filter::SECOND_SEED) | 1;
+        const uint64_t numBits = numWords_ * bloom_filter::BITS_PER_WORD;
+
+        for (uint32_t i = 0; contained && (i < numHashes_); i++) {
+            uint64_t bit = (h1 + i * h2) % numBits;
+            contained = ((words_[bit / bloom_filter::BITS_PER_WORD] >> (bit % bloom_filter::BITS_PER_WORD)) & 1) != 0;
+        }
+    }
+
+    return contained;
+}
+
+/**
+ * Loads the filter file if it matches the given
+ * version of the properties file.
+ *
+ * @param stamp the properties file stamp
+ * @return true if loaded, false otherwise
+ */
+bool PropsBloomFilter::load(const ftl::FileStamp& stamp) {
+    bool loaded = false;
+    filter_.reset(new MappedFile(filterPath_));
+
+    if (filter_->isOpen() && (filter_->size() >= sizeof(bloom_filter::FilterHeader))) {
+        const auto* header = reinterpret_cast<const bloom_filter::FilterHeader*>(filter_->data());
+        size_t wordsOffset = sizeof(bloom_filter::FilterHeader) + IndexFile::getPaddedSize(header->separatorLength_);
+
+        loaded = (memcmp(header->magic_, bloom_filter::FILTER_MAGIC, sizeof(header->magic_)) == 0)
+                 && (header->version_ == bloom_filter::FILTER_VERSION)
+                 && (header->mtime_ == stamp.mtime_) && (header->size_ == stamp.size_) && (header->inode_ == stamp.inode_)
+                 && (header->separatorLength_ == separator_.size())
+                 && (filter_->size() == wordsOffset + header->numWords_ * sizeof(uint64_t))
+                 && (memcmp(filter_->data() + sizeof(bloom_filter::FilterHeader), separator_.data(), separator_.size()) == 0);
+
+        if (loaded) {
+            words_ = reinterpret_cast<const uint64_t*>(filter_->data() + wordsOffset);
+            numWords_ = static_cast<size_t>(header->numWords_);
+            numHashes_ = header->numHashes_;
+        }
+    }
+
+    if (!loaded) {
+        filter_.reset();
+    }
+
+    return loaded;
+}
+
+/**
+ * Builds the filter scanning the properties file and
+ * stores it (failing to store it is not an error).
+ *
+ * @param fileName the absolute path to the properties file
+ * @param stamp the properties file stamp
+ * @return true if built, false otherwise
+ */
+bool PropsBloomFilter::build(const std::string& fileName, const ftl::FileStamp& stamp) {
+    MappedFile source(fileName);
+
+    // Discard the filter if the file changed while being mapped
+    ftl::FileStamp mappedStamp{};
+    if (!source.isOpen() || !FileUtils::getFileStamp(fileName, mappedStamp)
+        || (memcmp(&stamp, &mappedStamp, sizeof(ftl::FileStamp)) != 0)) {
+        return false;
+    }
+
+    const char* data = source.data();
+    const char* end = data + source.size();
+    const size_t sepSize = separator_.size();
+    std::vector<std::string> keys;
+
+    const char* lineStart = data;
+    while (lineStart < end) {
+        auto* eol = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart));
+        const char* lineEnd = (eol != nullptr) ? eol : end;
+        auto lineLength = static_cast<size_t>(lineEnd - lineStart);
+
+        // The key spans up to the first (case-sensitive) separator and needs a non empty value
+        if ((lineLength > 0) && (*lineStart != '#')) {
+            const char* sep = std::search(lineStart, lineEnd, separator_.begin(), separator_.end());
+            if ((sep != lineEnd) && (sep > lineStart) && (sep + sepSize < lineEnd)) {
+                keys.push_back(literal::toLower(std::string(lineStart, static_cast<size_t>(sep - lineStart))));
+            }
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    size_t numBits = std::max(keys.size() * bloom_filter::BITS_PER_KEY, bloom_filter::BITS_PER_WORD);
+    builtWords_.assign((numBits + bloom_filter::BITS_PER_WORD - 1) / bloom_filter::BITS_PER_WORD, 0);
+    words_ = builtWords_.data();
+    numWords_ = builtWords_.size();
+
+    for (auto& key : keys) {
+        add(key.data(), key.size());
+    }
+
+    store(stamp);
+    return true;
+}
+
+/**
+ * Adds a (lowercased) key to the filter being built.
+ *
+ * @param key the start of the key
+ * @param length the length of the key
+ */
+void PropsBloomFilter::add(const char* key, const size_t& length) {
+    uint64_t h1 = hash_key(key, length, bloom_filter::FIRST_SEED);
+    uint64_t h2 = hash_key(key, length, bloom_filter::SECOND_SEED) | 1;
+    const uint64_t numBits = numWords_ * bloom_filter::BITS_PER_WORD;
+
+    for (uint32_t i = 0; i < numHashes_; i++) {
+        uint64_t bit = (h1 + i * h2) % numBits;
+        builtWords_[bit / bloom_filter::BITS_PER_WORD] |= (1ULL << (bit % bloom_filter::BITS_PER_WORD));
+    }
+}
+
+/**
+ * Writes the built filter to the filter file.
+ *
+ * @param stamp the properties file stamp
+ * @return true if written, false otherwise
+ */
+bool PropsBloomFilter::store(const ftl::FileStamp& stamp) const {
+    bloom_filter::FilterHeader header{};
+    memcpy(header.magic_, bloom_filter::FILTER_MAGIC, sizeof(header.magic_));
+    header.version_ = bloom_filter::FILTER_VERSION;
+    header.separatorLength_ = static_cast<uint32_t>(separator_.size());
+    header.mtime_ = stamp.mtime_;
+    header.size_ = stamp.size_;
+    header.inode_ = stamp.inode_;
+    header.numWords_ = numWords_;
+    header.numHashes_ = numHashes_;
+
+    std::string separator = separator_;
+    separator.resize(IndexFile::getPaddedSize(separator_.size()), '\0');
+
+    return IndexFile::write(filterPath_, { index_file::block(&header, sizeof(header)),
+                                           index_file::block(separator.data(), separator.size()),
+                                           index_file::block(words_, numWords_ * sizeof(uint64_t)) });
+}
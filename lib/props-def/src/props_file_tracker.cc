@@ -21,6 +21,10 @@
 #include <string_utils.h>
 #include <parser/toml.hpp>
 #include <props_config.h>
+#include <mapped_file.h>
+#include <thread_pool.h>
+#include <cstring>
+#include "props_index_file.h"
 
 
 /**
@@ -33,8 +37,69 @@ std::string normalizeGroup(const std::string& group);
  */
 namespace tracker {
     static const char* TRACKER_CONFIG_FILE_NAME = "props-tracker.conf";
-    static const long DEFAULT_MAX_TRACKED_FILES = 20;
+    static const long DEFAULT_MAX_TRACKED_FILES = 0;
     static const char* MAX_TRACKED_FILES = "general.max_tracked_files";
+    static const char* SNAPSHOT_FILE_NAME = ".props-tracker.snapshot";
+    static const char SNAPSHOT_MAGIC[] = "PROPSTRK";
+    static const uint32_t SNAPSHOT_VERSION = 1;
+    static const uint32_t MASTER_FLAG = 1;
+    static const char* JOURNAL_FILE_NAME = ".props-tracker.journal";
+    static const char JOURNAL_MAGIC[] = "PROPSJRN";
+    static const uint32_t JOURNAL_VERSION = 1;
+    static const uint32_t JOURNAL_STORE = 1;
+    static const uint32_t JOURNAL_REMOVE = 2;
+    static const size_t JOURNAL_MIN_COMPACT_SIZE = 64 * 1024;
+    static const size_t PROGRESS_MIN_FILES = 1000;
+
+    /**
+     * Header of the snapshot file. Identifies the version
+     * of the tracker config file the snapshot was taken from.
+     */
+    typedef struct SnapshotHeader {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t numFiles_;
+        uint64_t mtime_;
+        uint64_t size_;
+        uint64_t inode_;
+    } SnapshotHeader;
+
+    /**
+     * Entry of a tracked file in the snapshot. The entries are
+     * followed by the location, alias and group of every file.
+     */
+    typedef struct SnapshotEntry {
+        uint32_t flags_;
+        uint32_t locationLength_;
+        uint32_t aliasLength_;
+        uint32_t groupLength_;
+    } SnapshotEntry;
+
+    /**
+     * Header of the journal file. Identifies the version of
+     * the tracker config file the journal changes apply to.
+     */
+    typedef struct JournalHeader {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t reserved_;
+        uint64_t mtime_;
+        uint64_t size_;
+        uint64_t inode_;
+    } JournalHeader;
+
+    /**
+     * Record of the journal. Stores the whole state of a file
+     * (location, alias and group follow the record) or its
+     * removal (only the location follows).
+     */
+    typedef struct JournalRecord {
+        uint32_t operation_;
+        uint32_t flags_;
+        uint32_t locationLength_;
+        uint32_t aliasLength_;
+        uint32_t groupLength_;
+    } JournalRecord;
 }
 
 /**
@@ -71,45 +136,323 @@ PropsFileTracker::PropsFileTracker() {
  */
 void PropsFileTracker::parseTrackerConfig() {
     auto configFilePath = config::CONFIG_FULL_PATH() + tracker::TRACKER_CONFIG_FILE_NAME;
-    std::string masterFileName;
     Result result{res::VALID};
 
     if (FileUtils::fileExists(configFilePath)) {
-        try {
-            const auto data = toml::parse(configFilePath);
-
-            toml::value trackingSection = toml::find<toml::value>(data, "Tracking");
-            toml::array fileArray = toml::find<toml::array>(trackingSection, "files");
-            for (auto &file : fileArray) {
-                toml::value fileTable = toml::get<toml::value>(file);
-
-                const auto alias     = toml::find_or<std::string>(fileTable, "alias", "");
-                const auto master    = toml::find_or<bool>(fileTable, "master", false);
-                const auto group     = toml::find_or<std::string>(fileTable, "group", "");
-                const auto &location = toml::find<std::string>(fileTable, "location");
-
-                // Creates the new props file
-                PropsFile propsFile;
-                propsFile.setFileName(location);
-                propsFile.setAlias(alias);
-                propsFile.setMaster(master);
-                propsFile.setGroup(group);
-                result = storeFile(propsFile);
-                if (!result.isValid()) {
-                    std::string msg = "WARN: "+result.getMessage()+".Skipping";
-                    result.setMessage(msg);
-                }
-                result.showMessage();
+        std::list<PropsFile> files;
+        ftl::FileStamp stamp{};
+        bool stamped = FileUtils::getFileStamp(configFilePath, stamp);
+
+        // Parse the config only if changed since the last snapshot
+        if (!stamped || !readSnapshot(stamp, files)) {
+            readTrackerConfig(configFilePath, files);
+            if (stamped) {
+                writeSnapshot(stamp, files);
+            }
+        }
+
+        // Apply the changes made since the config was written
+        bool stale = stamped && readJournal(stamp, files);
+
+        // The files are checked only when used (see validate)
+        for (auto &propsFile : files) {
+            result = trackFile(propsFile);
+            if (!result.isValid()) {
+                std::string msg = "WARN: "+result.getMessage()+".Skipping";
+                result.setMessage(msg);
             }
-        } catch (std::exception &e) {
-            throw InitializationException("Error parsing tracker configuration file. Details : " + std::string(e.what()));
+            result.showMessage();
         }
 
         // Sets first tracked file as master if not set yet
         if (masterFile_ == nullptr) {
             setFirstAsMaster();
         }
+        journaledMaster_ = masterFile_;
+
+        // Fold the changes of a stale journal into the config before it diverges further
+        if (stale) {
+            result = save();
+            result.showMessage();
+        }
+    }
+}
+
+/**
+ * Reads the files stored in the given tracker config file.
+ *
+ * @param configFilePath the path to the tracker config file
+ * @param files the files read
+ */
+void PropsFileTracker::readTrackerConfig(const std::string& configFilePath, std::list<PropsFile>& files) {
+    try {
+        const auto data = toml::parse(configFilePath);
+
+        toml::value trackingSection = toml::find<toml::value>(data, "Tracking");
+        toml::array fileArray = toml::find<toml::array>(trackingSection, "files");
+        for (auto &file : fileArray) {
+            toml::value fileTable = toml::get<toml::value>(file);
+
+            const auto alias     = toml::find_or<std::string>(fileTable, "alias", "");
+            const auto master    = toml::find_or<bool>(fileTable, "master", false);
+            const auto group     = toml::find_or<std::string>(fileTable, "group", "");
+            const auto &location = toml::find<std::string>(fileTable, "location");
+
+            // Creates the new props file
+            PropsFile propsFile;
+            propsFile.setFileName(location);
+            propsFile.setAlias(alias);
+            propsFile.setMaster(master);
+            propsFile.setGroup(group);
+            files.push_back(propsFile);
+        }
+    } catch (std::exception &e) {
+        throw InitializationException("Error parsing tracker configuration file. Details : " + std::string(e.what()));
+    }
+}
+
+/**
+ * Reads the files stored in the tracker snapshot if it
+ * matches the given version of the tracker config file.
+ *
+ * @param stamp the tracker config file stamp
+ * @param files the files read
+ * @return true if read, false otherwise
+ */
+bool PropsFileTracker::readSnapshot(const ftl::FileStamp& stamp, std::list<PropsFile>& files) {
+    MappedFile snapshot(config::CONFIG_FULL_PATH() + tracker::SNAPSHOT_FILE_NAME);
+    bool loaded = false;
+
+    if (snapshot.isOpen() && (snapshot.size() >= sizeof(tracker::SnapshotHeader))) {
+        const auto* header = reinterpret_cast<const tracker::SnapshotHeader*>(snapshot.data());
+        const size_t entriesSize = header->numFiles_ * sizeof(tracker::SnapshotEntry);
+
+        loaded = (memcmp(header->magic_, tracker::SNAPSHOT_MAGIC, sizeof(header->magic_)) == 0)
+                 && (header->version_ == tracker::SNAPSHOT_VERSION)
+                 && (header->mtime_ == stamp.mtime_) && (header->size_ == stamp.size_) && (header->inode_ == stamp.inode_)
+                 && (snapshot.size() - sizeof(tracker::SnapshotHeader) >= entriesSize);
+
+        if (loaded) {
+            const auto* entries = reinterpret_cast<const tracker::SnapshotEntry*>(snapshot.data() + sizeof(tracker::SnapshotHeader));
+            const char* data = snapshot.data() + sizeof(tracker::SnapshotHeader) + entriesSize;
+            const char* end = snapshot.data() + snapshot.size();
+
+            for (uint32_t i = 0; loaded && (i < header->numFiles_); i++) {
+                const auto& entry = entries[i];
+                const size_t length = static_cast<size_t>(entry.locationLength_) + entry.aliasLength_ + entry.groupLength_;
+                loaded = (static_cast<size_t>(end - data) >= length);
+
+                if (loaded) {
+                    PropsFile propsFile;
+                    propsFile.setFileName(std::string(data, entry.locationLength_));
+                    propsFile.setAlias(std::string(data + entry.locationLength_, entry.aliasLength_));
+                    propsFile.setGroup(std::string(data + entry.locationLength_ + entry.aliasLength_, entry.groupLength_));
+                    propsFile.setMaster((entry.flags_ & tracker::MASTER_FLAG) != 0);
+                    files.push_back(propsFile);
+                    data += length;
+                }
+            }
+        }
+    }
+
+    if (!loaded) {
+        files.clear();
+    }
+
+    return loaded;
+}
+
+/**
+ * Writes the given files to the tracker snapshot for the
+ * given version of the tracker config file (failing to
+ * write it is not an error).
+ *
+ * @param stamp the tracker config file stamp
+ * @param files the files to write
+ */
+void PropsFileTracker::writeSnapshot(const ftl::FileStamp& stamp, const std::list<PropsFile>& files) {
+    tracker::SnapshotHeader header{};
+    memcpy(header.magic_, tracker::SNAPSHOT_MAGIC, sizeof(header.magic_));
+    header.version_ = tracker::SNAPSHOT_VERSION;
+    header.numFiles_ = static_cast<uint32_t>(files.size());
+    header.mtime_ = stamp.mtime_;
+    header.size_ = stamp.size_;
+    header.inode_ = stamp.inode_;
+
+    std::vector<tracker::SnapshotEntry> entries;
+    std::string data;
+    entries.reserve(files.size());
+
+    for (auto &propsFile : files) {
+        entries.push_back(tracker::SnapshotEntry{propsFile.isMaster() ? tracker::MASTER_FLAG : 0,
+                                                 static_cast<uint32_t>(propsFile.getFileName().size()),
+                                                 static_cast<uint32_t>(propsFile.getAlias().size()),
+                                                 static_cast<uint32_t>(propsFile.getGroup().size())});
+        data.append(propsFile.getFileName()).append(propsFile.getAlias()).append(propsFile.getGroup());
+    }
+
+    IndexFile::write(config::CONFIG_FULL_PATH() + tracker::SNAPSHOT_FILE_NAME,
+                     { index_file::block(&header, sizeof(header)),
+                       index_file::block(entries.data(), entries.size() * sizeof(tracker::SnapshotEntry)),
+                       index_file::block(data.data(), data.size()) });
+}
+
+/**
+ * Replays the changes stored in the tracker journal on the
+ * given files. Journals started from another version of the
+ * tracker config file (i.e. edited by hand) are replayed on top
+ * of it too, warning that they must be folded into the config.
+ *
+ * @param stamp the tracker config file stamp
+ * @param files the files read from the tracker config file
+ * @return true if a stale journal was replayed, false otherwise
+ */
+bool PropsFileTracker::readJournal(const ftl::FileStamp& stamp, std::list<PropsFile>& files) {
+    MappedFile journal(config::CONFIG_FULL_PATH() + tracker::JOURNAL_FILE_NAME);
+    bool stale = false;
+
+    if (journal.isOpen() && (journal.size() >= sizeof(tracker::JournalHeader))) {
+        const auto* header = reinterpret_cast<const tracker::JournalHeader*>(journal.data());
+        bool valid = (memcmp(header->magic_, tracker::JOURNAL_MAGIC, sizeof(header->magic_)) == 0)
+                     && (header->version_ == tracker::JOURNAL_VERSION);
+        stale = valid && ((header->mtime_ != stamp.mtime_) || (header->size_ != stamp.size_) || (header->inode_ != stamp.inode_));
+
+        if (stale) {
+            Result result{res::ERROR};
+            result.setSeverity(res::WARN);
+            result.setMessage("WARN: Tracker config changed since the last tracker changes were saved, applying them on top of it");
+            result.showMessage();
+        }
+
+        if (valid) {
+            size_t offset = sizeof(tracker::JournalHeader);
+            std::unordered_map<std::string, std::list<PropsFile>::iterator> filesMap;
+            auto master = files.end();
+
+            for (auto it = files.begin(); it != files.end(); ++it) {
+                filesMap[it->getFileName()] = it;
+                master = it->isMaster() ? it : master;
+            }
+
+            // Stop at the first incomplete record (if any)
+            while (journal.size() - offset >= sizeof(tracker::JournalRecord)) {
+                tracker::JournalRecord record{};
+                memcpy(&record, journal.data() + offset, sizeof(record));
+                const size_t length = static_cast<size_t>(record.locationLength_) + record.aliasLength_ + record.groupLength_;
+
+                if (journal.size() - offset - sizeof(record) < length) {
+                    break;
+                }
+
+                const char* data = journal.data() + offset + sizeof(record);
+                const std::string location(data, record.locationLength_);
+                auto found = filesMap.find(location);
+
+                if (record.operation_ == tracker::JOURNAL_STORE) {
+                    PropsFile propsFile;
+                    propsFile.setFileName(location);
+                    propsFile.setAlias(std::string(data + record.locationLength_, record.aliasLength_));
+                    propsFile.setGroup(std::string(data + record.locationLength_ + record.aliasLength_, record.groupLength_));
+                    propsFile.setMaster((record.flags_ & tracker::MASTER_FLAG) != 0);
+
+                    auto it = (found != filesMap.end()) ? found->second : files.insert(files.end(), propsFile);
+                    *it = propsFile;
+                    filesMap[location] = it;
+
+                    if (propsFile.isMaster()) {
+                        if ((master != files.end()) && (master != it)) {
+                            master->setMaster(false);
+                        }
+                        master = it;
+                    }
+                } else if (found != filesMap.end()) {
+                    master = (master == found->second) ? files.end() : master;
+                    files.erase(found->second);
+                    filesMap.erase(found);
+                }
+
+                offset += sizeof(record) + length;
+            }
+
+            // A torn record (or stale journal) is dropped by the next full rewrite
+            journalSize_ = offset;
+            compact_ = stale || (offset != journal.size());
+        }
+    }
+
+    return stale;
+}
+
+/**
+ * Records the current state of the given file in the
+ * pending journal changes.
+ *
+ * @param propsFile the props file
+ */
+void PropsFileTracker::journalFile(const PropsFile& propsFile) {
+    const tracker::JournalRecord record{tracker::JOURNAL_STORE,
+                                        propsFile.isMaster() ? tracker::MASTER_FLAG : 0,
+                                        static_cast<uint32_t>(propsFile.getFileName().size()),
+                                        static_cast<uint32_t>(propsFile.getAlias().size()),
+                                        static_cast<uint32_t>(propsFile.getGroup().size())};
+
+    journal_.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    journal_.append(propsFile.getFileName()).append(propsFile.getAlias()).append(propsFile.getGroup());
+}
+
+/**
+ * Records the removal of the given file in the
+ * pending journal changes.
+ *
+ * @param fileName the path to the file
+ */
+void PropsFileTracker::journalRemoval(const std::string& fileName) {
+    const tracker::JournalRecord record{tracker::JOURNAL_REMOVE, 0, static_cast<uint32_t>(fileName.size()), 0, 0};
+
+    journal_.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    journal_.append(fileName);
+}
+
+/**
+ * Appends the pending changes to the tracker journal unless
+ * the tracker config file needs to be rewritten (not existing,
+ * journal too large or unusable).
+ *
+ * @return true if appended, false if a full rewrite is needed
+ */
+bool PropsFileTracker::appendTrackerJournal() {
+    auto configFilePath = config::CONFIG_FULL_PATH() + tracker::TRACKER_CONFIG_FILE_NAME;
+    ftl::FileStamp stamp{};
+    bool appended = !compact_ && FileUtils::getFileStamp(configFilePath, stamp);
+
+    // Compact once the journal outgrows the config (rewrites stay amortized)
+    if (appended && !journal_.empty()) {
+        const size_t maxJournalSize = std::max<size_t>(tracker::JOURNAL_MIN_COMPACT_SIZE, stamp.size_);
+        const std::string journalFilePath = config::CONFIG_FULL_PATH() + tracker::JOURNAL_FILE_NAME;
+        appended = (journalSize_ + journal_.size() <= maxJournalSize);
+
+        if (appended && (journalSize_ == 0)) {
+            tracker::JournalHeader header{};
+            memcpy(header.magic_, tracker::JOURNAL_MAGIC, sizeof(header.magic_));
+            header.version_ = tracker::JOURNAL_VERSION;
+            header.mtime_ = stamp.mtime_;
+            header.size_ = stamp.size_;
+            header.inode_ = stamp.inode_;
+
+            appended = IndexFile::write(journalFilePath, { index_file::block(&header, sizeof(header)),
+                                                           index_file::block(journal_.data(), journal_.size()) });
+            journalSize_ = appended ? sizeof(header) : 0;
+        } else if (appended) {
+            appended = IndexFile::append(journalFilePath, { index_file::block(journal_.data(), journal_.size()) });
+        }
+
+        if (appended) {
+            journalSize_ += journal_.size();
+            journal_.clear();
+        }
     }
+
+    return appended;
 }
 
 /**
@@ -117,8 +460,8 @@ void PropsFileTracker::parseTrackerConfig() {
  * as master.
  */
 void PropsFileTracker::setFirstAsMaster() {
-    if (!trackedFiles_.empty()) {
-        auto &front = trackedFiles_.front();
+    if (firstEntry_ != tracker::NO_ENTRY) {
+        auto &front = entries_[firstEntry_].file_;
         front.setMaster(true);
         updateMasterFile(&front);
     }
@@ -133,11 +476,21 @@ void PropsFileTracker::setFirstAsMaster() {
  */
 void PropsFileTracker::addFiles(std::list<PropsFile> &files, Result &result, const bool& updateConfig) {
 
+    std::vector<PropsFile*> pendingFiles;
+    pendingFiles.reserve(files.size());
+    for (auto& file : files) {
+        pendingFiles.push_back(&file);
+    }
+
+    std::vector<std::string> fullFilePaths(pendingFiles.size());
+    std::vector<char> exists(pendingFiles.size());
+    resolveFiles(pendingFiles, fullFilePaths, exists);
+
     size_t numFailed = 0;
     res::severity severity{res::NORMAL};
-    for (auto& file : files) {
+    for (size_t i = 0; i < pendingFiles.size(); i++) {
         Result partialResult{res::VALID};
-        addFile(file, partialResult, false);
+        addResolvedFile(*pendingFiles[i], fullFilePaths[i], (exists[i] != 0), partialResult);
         if (!partialResult.isValid()) {
             std::string errMsg = (partialResult.getSeverity() == res::WARN) ? "WARN: " : "ERROR: ";
             partialResult.setMessage(errMsg + partialResult.getMessage());
@@ -185,7 +538,26 @@ void PropsFileTracker::addFile(PropsFile &file, Result &result, const bool& upda
 
     std::string fullFilePath = FileUtils::getAbsolutePath(file.getFileName());
 
-    if (FileUtils::fileExists(fullFilePath)) {
+    addResolvedFile(file, fullFilePath, FileUtils::fileExists(fullFilePath), result);
+
+    // Update the config
+    if (result.isValid() && updateConfig) {
+        result = save();
+    }
+}
+
+/**
+ * Adds the given file to the tracker once its absolute
+ * path has been resolved and checked.
+ *
+ * @param file the file to add
+ * @param fullFilePath the absolute path to the file
+ * @param exists true if the file exists
+ * @param result the result of the operation
+ */
+void PropsFileTracker::addResolvedFile(PropsFile &file, const std::string& fullFilePath, const bool& exists, Result &result) {
+
+    if (exists) {
 
         file.setFileName(fullFilePath);
 
@@ -194,11 +566,10 @@ void PropsFileTracker::addFile(PropsFile &file, Result &result, const bool& upda
             file.setMaster(true);
         }
 
-        result = storeFile(file);
+        result = trackFile(file);
 
-        // Update the config
-        if (result.isValid() && updateConfig) {
-            result = save();
+        if (result.isValid()) {
+            journalFile(*getFile(file.getFileName()));
         }
     } else {
         result = res::ERROR;
@@ -206,6 +577,55 @@ void PropsFileTracker::addFile(PropsFile &file, Result &result, const bool& upda
     }
 }
 
+/**
+ * Resolves the absolute paths of the given files and checks
+ * their existence using the worker pool (reporting the
+ * progress on a terminal for large lists).
+ *
+ * @param files the files to resolve
+ * @param fullFilePaths the absolute paths of the files
+ * @param exists the existence flag of every file
+ */
+void PropsFileTracker::resolveFiles(const std::vector<PropsFile*>& files, std::vector<std::string>& fullFilePaths, std::vector<char>& exists) {
+    ThreadPool& threadPool = ThreadPool::getDefault();
+    const size_t numChunks = std::min(files.size(), threadPool.getNumThreads() * 4);
+    const bool showProgress = (files.size() >= tracker::PROGRESS_MIN_FILES) && rang::rang_implementation::isTerminal(std::cerr.rdbuf());
+    std::vector<std::future<void>> resolved;
+
+    try {
+        // Split the files in contiguous ranges (several per thread to balance slow lookups)
+        for (size_t i = 0; i < numChunks; i++) {
+            const size_t begin = files.size() * i / numChunks;
+            const size_t end   = files.size() * (i + 1) / numChunks;
+            resolved.push_back(threadPool.submit([&files, &fullFilePaths, &exists, begin, end]() {
+                for (size_t j = begin; j < end; j++) {
+                    fullFilePaths[j] = FileUtils::getAbsolutePath(files[j]->getFileName());
+                    exists[j] = FileUtils::fileExists(fullFilePaths[j]) ? 1 : 0;
+                }
+            }));
+        }
+
+        for (size_t i = 0; i < resolved.size(); i++) {
+            resolved[i].get();
+            if (showProgress) {
+                std::cerr << "\rChecking files [" << files.size() * (i + 1) / numChunks << "/" << files.size() << "]" << std::flush;
+            }
+        }
+    } catch (...) {
+        // The pending chunks write into the given vectors, wait for them before unwinding
+        for (auto& chunk : resolved) {
+            if (chunk.valid()) {
+                chunk.wait();
+            }
+        }
+        throw;
+    }
+
+    if (showProgress) {
+        std::cerr << std::endl;
+    }
+}
+
 /**
  * Removes the given file from the tracker
  *
@@ -214,12 +634,9 @@ void PropsFileTracker::addFile(PropsFile &file, Result &result, const bool& upda
 void PropsFileTracker::removeFile(const std::string &file, Result& result) {
     std::string fullFilePath = FileUtils::getAbsolutePath(file);
     result = res::ERROR;
-    if (trackedMapFiles_.count(fullFilePath) != 0) {
-        auto* pFile = trackedMapFiles_[fullFilePath];
-        trackedMapFiles_.erase(fullFilePath);
-        aliasedMapFiles_.erase(pFile->getAlias());
-        removeFileFromGroup(pFile);
-        trackedFiles_.remove(*pFile);
+    auto it = trackedMapFiles_.find(fullFilePath);
+    if (it != trackedMapFiles_.end()) {
+        untrackEntry(it->second);
         result = save();
 
         // Update the config
@@ -239,13 +656,10 @@ void PropsFileTracker::removeFile(const std::string &file, Result& result) {
  */
 void PropsFileTracker::removeFileByAlias(const std::string &fileAlias, Result& result) {
     result = res::ERROR;
-    if (aliasedMapFiles_.count(fileAlias) != 0) {
-        auto* pFile = aliasedMapFiles_[fileAlias];
-        auto file = pFile->getFileName();
-        aliasedMapFiles_.erase(fileAlias);
-        trackedMapFiles_.erase(pFile->getFileName());
-        removeFileFromGroup(pFile);
-        trackedFiles_.remove(*pFile);
+    auto it = aliasedMapFiles_.find(fileAlias);
+    if (it != aliasedMapFiles_.end()) {
+        auto file = entries_[it->second].file_.getFileName();
+        untrackEntry(it->second);
         result = save();
 
         // Update the config
@@ -265,18 +679,19 @@ void PropsFileTracker::removeFileByAlias(const std::string &fileAlias, Result& r
  * @param output the output stream
 */
 void PropsFileTracker::listTracked(std::ostream& output) const {
-    if (trackedFiles_.empty()) {
+    if (numTracked_ == 0) {
         output << std::endl << rang::fgB::yellow << "No files tracked" << rang::fg::reset << std::endl;
     } else {
         // get max file size
         size_t maxFileNameSize = 0;
-        for (auto& file : trackedMapFiles_) {
-            std::string fileName = file.second->isMaster() ? "(M) " + file.first : file.first;
-            maxFileNameSize = (maxFileNameSize < fileName.size()) ? fileName.size() : maxFileNameSize;
+        for (size_t entry = firstEntry_; entry != tracker::NO_ENTRY; entry = entries_[entry].next_) {
+            const auto& file = entries_[entry].file_;
+            size_t fileNameSize = file.getFileName().size() + (file.isMaster() ? 4 : 0);
+            maxFileNameSize = (maxFileNameSize < fileNameSize) ? fileNameSize : maxFileNameSize;
         }
 
-        if (!trackedFiles_.empty()) {
-            output << rang::fgB::green << "\n " << trackedFiles_.size() << " file" << ((trackedFiles_.size()!=1) ? "s" : "") << " tracked";
+        if (numTracked_ != 0) {
+            output << rang::fgB::green << "\n " << numTracked_ << " file" << ((numTracked_ != 1) ? "s" : "") << " tracked";
             // Hide group count if only 1 group, default group
             if (!((trackedGroups_.size() == 1) && (trackedGroups_.count(tracker::DEFAULT_GROUP) != 0))) {
                 output << ", " << trackedGroups_.size() << " group" << ((trackedGroups_.size() != 1) ? "s" : "");
@@ -284,11 +699,19 @@ void PropsFileTracker::listTracked(std::ostream& output) const {
             output << rang::fg::reset << std::endl;
         }
 
+        // Groups are listed by name
+        std::vector<std::string> groupNames;
+        groupNames.reserve(trackedGroups_.size());
         for (auto& trackedGroup : trackedGroups_) {
-            printTrackedGroup(output, maxFileNameSize, trackedGroup.first);
+            groupNames.push_back(trackedGroup.first);
         }
+        std::sort(groupNames.begin(), groupNames.end());
 
-        if (!trackedFiles_.empty()) {
+        for (auto& groupName : groupNames) {
+            printTrackedGroup(output, maxFileNameSize, groupName);
+        }
+
+        if (numTracked_ != 0) {
             output << std::endl;
         }
     }
@@ -302,17 +725,18 @@ void PropsFileTracker::listTracked(std::ostream& output) const {
  * @return
  */
 void PropsFileTracker::printTrackedGroup(std::ostream &output, size_t maxFileNameSize, const std::string& groupName) const {
-    size_t i = 0;
-    if (trackedGroups_.count(groupName) != 0) {
-        const auto &trackedFiles = trackedGroups_.at(groupName);
+    auto it = trackedGroups_.find(groupName);
+    if (it != trackedGroups_.end()) {
+        const auto &trackedGroup = it->second;
 
         // Hide title if only 1 group, default group
         if (!((trackedGroups_.size() == 1) && (trackedGroups_.count(tracker::DEFAULT_GROUP) != 0))) {
             output << rang::fgB::blue << "\n " << ((groupName == tracker::DEFAULT_GROUP) ? groupName.substr(1, groupName.size()-1) : groupName) << rang::fg::reset;
         }
 
-        for (auto &propsFile : trackedFiles) {
-            bool last = (i == trackedFiles.size() - 1);
+        for (size_t entry = trackedGroup.first_; entry != tracker::NO_ENTRY; entry = entries_[entry].groupNext_) {
+            const auto* propsFile = &entries_[entry].file_;
+            bool last = (entry == trackedGroup.last_);
             std::string masterDetail = propsFile->getFileName();
 
             output << std::endl << " " << (last ? "└" : "├") << "─ ";
@@ -329,7 +753,6 @@ void PropsFileTracker::printTrackedGroup(std::ostream &output, size_t maxFileNam
 
             output << rang::fgB::yellow << (alias.empty() ? "" : padding.append(" => \"") + alias + "\"")
                    << rang::fg::reset;
-            i++;
         }
 
         output << std::endl;
@@ -356,7 +779,13 @@ Result PropsFileTracker::setAlias(const std::string& fileName, const std::string
             res.setSeverity(res::CRITICAL);
             res.setMessage("The alias \"" + fileAlias + "\" is already used");
         } else {
+            size_t entry = getEntry(propsFile);
+            if (!propsFile->getAlias().empty()) {
+                aliasedMapFiles_.erase(propsFile->getAlias());
+            }
             propsFile->setAlias(fileAlias);
+            aliasedMapFiles_[fileAlias] = entry;
+            journalFile(*propsFile);
             res = save();
             if (res.isValid()) {
                 res.setMessage("Alias \"" + fileAlias + "\" set for file \"" + fileName + "\"");
@@ -382,6 +811,7 @@ Result PropsFileTracker::removeAlias(const std::string& alias) {
     if (propsFile != nullptr) {
         propsFile->setAlias("");
         aliasedMapFiles_.erase(alias);
+        journalFile(*propsFile);
         res = save();
         if (res.isValid()) {
             res.setMessage("Alias \""+alias+"\" removed");
@@ -415,6 +845,8 @@ Result PropsFileTracker::removeFileAlias(const std::string& fileName) {
             res.setMessage("File \"" + fileName + "\" not aliased");
         } else {
             propsFile->setAlias("");
+            aliasedMapFiles_.erase(alias);
+            journalFile(*propsFile);
             res = save();
             if (res.isValid()) {
                 res.setMessage("Alias \""+alias+"\" removed");
@@ -439,8 +871,9 @@ Result PropsFileTracker::removeFileAlias(const std::string& fileName) {
  */
 PropsFile* PropsFileTracker::getFileWithAlias(const std::string& alias) {
     PropsFile* propsFile = nullptr;
-    if (aliasedMapFiles_.count(alias)!=0) {
-        propsFile = aliasedMapFiles_[alias];
+    auto it = aliasedMapFiles_.find(alias);
+    if (it != aliasedMapFiles_.end()) {
+        propsFile = &entries_[it->second].file_;
     }
 
     return propsFile;
@@ -455,70 +888,59 @@ PropsFile* PropsFileTracker::getFileWithAlias(const std::string& alias) {
  */
 PropsFile* PropsFileTracker::getFile(const std::string& file) {
     PropsFile* propsFile = nullptr;
-    if (trackedMapFiles_.count(file)!=0) {
-        propsFile = trackedMapFiles_[file];
+    auto it = trackedMapFiles_.find(file);
+    if (it != trackedMapFiles_.end()) {
+        propsFile = &entries_[it->second].file_;
     }
 
     return propsFile;
 }
 
 /**
- * Checks the file is valid and keeps a reference
- * in the tracker.
+ * Keeps a reference of the file in the tracker
+ * if not already tracked.
  *
  * @param propsFile the properties to store in the tracker
  */
-Result PropsFileTracker::storeFile(PropsFile &propsFile) {
+Result PropsFileTracker::trackFile(PropsFile &propsFile) {
 
     Result result{res::ERROR};
     result.setSeverity(res::WARN);
 
-    // Skip the file if not existing
-    if (FileUtils::fileExists(propsFile.getFileName())) {
-        if (trackedMapFiles_.count(propsFile.getFileName()) == 0) {
-                if (maxTrackedFiles_ > trackedFiles_.size()) {
-                    if (aliasedMapFiles_.count(propsFile.getAlias()) == 0) {
-                        // Keep the file in the list
-                        trackedFiles_.push_back(propsFile);
-
-                        PropsFile *filePtr = &trackedFiles_.back();
-
-                        // Keep a reference for the alias and the file for fast access
-                        trackedMapFiles_[propsFile.getFileName()] = filePtr;
-                        if (!propsFile.getAlias().empty()) {
-                            aliasedMapFiles_[propsFile.getAlias()] = filePtr;
-                        }
-
-                        // Keep a reference in the group
-                        std::string groupName = normalizeGroup(propsFile.getGroup());
-
-                        if (trackedGroups_.count(groupName) == 0) {
-                            trackedGroups_[groupName] = std::list<PropsFile*>{};
-                        }
+    if (trackedMapFiles_.count(propsFile.getFileName()) == 0) {
+        if ((maxTrackedFiles_ == 0) || (maxTrackedFiles_ > numTracked_)) {
+            if (aliasedMapFiles_.count(propsFile.getAlias()) == 0) {
+                // Keep the file in the storage
+                size_t entry = allocateEntry(propsFile);
 
-                        trackedGroups_[groupName].push_back(filePtr);
+                PropsFile *filePtr = &entries_[entry].file_;
 
+                // Keep a reference for the alias and the file for fast access
+                trackedMapFiles_[propsFile.getFileName()] = entry;
+                if (!propsFile.getAlias().empty()) {
+                    aliasedMapFiles_[propsFile.getAlias()] = entry;
+                }
 
-                        // Set as new master (override)
-                        if (filePtr->isMaster()) {
-                            updateMasterFile(filePtr);
-                        }
+                // Keep a reference in the group
+                linkGroup(entry, normalizeGroup(propsFile.getGroup()));
 
-                        result = res::VALID;
-                        result.setSeverity(res::NORMAL);
-                    } else {
-                        result.setMessage("Alias [" + propsFile.getAlias() + "] already in use");
-                    }
-                } else {
-                    result.setMessage("Cannot add file [" + propsFile.getFileName() +
-                                      "], maximum number of tracked files reached (" +
-                                      std::to_string(maxTrackedFiles_) + ")");
+                // Set as new master (override)
+                if (filePtr->isMaster()) {
+                    updateMasterFile(filePtr);
                 }
+
+                result = res::VALID;
+                result.setSeverity(res::NORMAL);
+            } else {
+                result.setMessage("Alias [" + propsFile.getAlias() + "] already in use");
+            }
         } else {
-            result.setMessage("File [" + propsFile.getFileName() + "] already tracked");
+            result.setMessage("Cannot add file [" + propsFile.getFileName() +
+                              "], maximum number of tracked files reached (" +
+                              std::to_string(maxTrackedFiles_) + ")");
         }
     } else {
-        result.setMessage("File [" + propsFile.getFileName() + "] cannot be read");
+        result.setMessage("File [" + propsFile.getFileName() + "] already tracked");
     }
 
     return result;
@@ -531,8 +953,17 @@ Result PropsFileTracker::storeFile(PropsFile &propsFile) {
  */
 Result PropsFileTracker::save() {
     Result res{res::VALID};
+
+    // Master changes are not always made through the tracker
+    if ((masterFile_ != nullptr) && (masterFile_ != journaledMaster_)) {
+        journalFile(*masterFile_);
+    }
+    journaledMaster_ = masterFile_;
+
     try {
-        updateTrackerConfig();
+        if (!appendTrackerJournal()) {
+            updateTrackerConfig();
+        }
     } catch (std::exception& e) {
         res = res::ERROR;
         res.setSeverity(res::CRITICAL);
@@ -550,7 +981,7 @@ Result PropsFileTracker::save() {
 Result PropsFileTracker::clear() {
     Result res{res::VALID};
 
-    if (trackedFiles_.empty()) {
+    if (numTracked_ == 0) {
         res.setSeverity(res::WARN);
         res.setMessage("No files currently tracked");
     } else {
@@ -558,7 +989,17 @@ Result PropsFileTracker::clear() {
         aliasedMapFiles_.clear();
         trackedMapFiles_.clear();
 
-        trackedFiles_.clear();
+        entries_.clear();
+        freeEntries_.clear();
+        firstEntry_ = tracker::NO_ENTRY;
+        lastEntry_  = tracker::NO_ENTRY;
+        numTracked_ = 0;
+        masterFile_ = nullptr;
+        journaledMaster_ = nullptr;
+
+        // Nothing left to journal
+        journal_.clear();
+        compact_ = true;
 
         res = save();
 
@@ -571,12 +1012,10 @@ Result PropsFileTracker::clear() {
 }
 
 /**
- * Updates the tracker config file with the given tracked file.
- * In case the config file is not detected a full dump is performed.
- *
- * @param propsFile the properties file to track
+ * Updates or creates if needed, the tracker config file with the current
+ * tracked configuration, discarding the journal.
  */
-void PropsFileTracker::updateTrackerConfig() const {
+void PropsFileTracker::updateTrackerConfig() {
 
     auto configFilePath           = config::CONFIG_FULL_PATH() + tracker::TRACKER_CONFIG_FILE_NAME;
     std::string configFilePathTmp = config::CONFIG_FULL_PATH() + "." + tracker::TRACKER_CONFIG_FILE_NAME + ".tmp";
@@ -589,6 +1028,12 @@ void PropsFileTracker::updateTrackerConfig() const {
     // Perform a dump of the current config (existing extra comments are lost :()
     writeTrackerConfig(outputFilePath);
 
+    // Keep the snapshot in sync (renaming keeps the modification time)
+    ftl::FileStamp stamp{};
+    if (FileUtils::getFileStamp(outputFilePath, stamp)) {
+        writeSnapshot(stamp, getTrackedFiles());
+    }
+
     // Rename temporary file if needed
     if (outputFilePath == configFilePathTmp) {
         if (!FileUtils::rename(configFilePathTmp, configFilePath)) {
@@ -596,6 +1041,12 @@ void PropsFileTracker::updateTrackerConfig() const {
             throw ExecutionException("I/O Error updating tracker configuration file");
         }
     }
+
+    // The journal changes are part of the config now
+    FileUtils::remove(config::CONFIG_FULL_PATH() + tracker::JOURNAL_FILE_NAME);
+    journal_.clear();
+    journalSize_ = 0;
+    compact_ = false;
 }
 
 /**
@@ -615,7 +1066,8 @@ void PropsFileTracker::writeTrackerConfig(const std::string& outputFilePath) con
 
             outFile << "[Tracking]\nfiles = [";
             std::string prefix;
-            for (auto &propFile : trackedFiles_) {
+            for (size_t entry = firstEntry_; entry != tracker::NO_ENTRY; entry = entries_[entry].next_) {
+                const auto &propFile = entries_[entry].file_;
                 outFile << prefix << " {"
                         << (!propFile.getAlias().empty() ? "alias = \"" + propFile.getAlias() + "\", " : "")
                         << "location = \"" + propFile.getFileName() + "\""
@@ -623,7 +1075,7 @@ void PropsFileTracker::writeTrackerConfig(const std::string& outputFilePath) con
                         << (!propFile.getGroup().empty() ? ", group = \"" + propFile.getGroup() + "\"" : "") << "}";
                 prefix = ",\n"+ spacer + " ";
             }
-            outFile << ((trackedFiles_.size()>1) ? "\n" + spacer : " ") << "]" << std::endl;
+            outFile << ((numTracked_>1) ? "\n" + spacer : " ") << "]" << std::endl;
             outFile.close();
         } else {
             throw ExecutionException("Cannot write tracker config file");
@@ -632,17 +1084,172 @@ void PropsFileTracker::writeTrackerConfig(const std::string& outputFilePath) con
 }
 
 /**
- * Removes the given file from its group (if any).
+ * Retrieve all tracked files
+ *
+ * @return the list of tracked files
+ */
+std::list<PropsFile> PropsFileTracker::getTrackedFiles() const {
+    std::list<PropsFile> files;
+    for (size_t entry = firstEntry_; entry != tracker::NO_ENTRY; entry = entries_[entry].next_) {
+        files.push_back(entries_[entry].file_);
+    }
+
+    return files;
+}
+
+/**
+ * Retrieves the files associated with a given
+ * group.
+ *
+ * @param group the group name
+ * @param files the list to append the files of the group to
+ * @return true if the group exists, false otherwise
+ */
+bool PropsFileTracker::getGroup(const std::string& group, std::list<PropsFile>& files) const {
+    auto it = trackedGroups_.find(normalizeGroup(group));
+    bool found = (it != trackedGroups_.end());
+
+    if (found) {
+        for (size_t entry = it->second.first_; entry != tracker::NO_ENTRY; entry = entries_[entry].groupNext_) {
+            files.push_back(entries_[entry].file_);
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Stores a copy of the given file in a free slot (or a
+ * new one) linking it at the end of the tracked files.
  *
  * @param propsFile the props file
+ * @return the slot of the file
  */
-void PropsFileTracker::removeFileFromGroup(PropsFile* propsFile) {
-    if (propsFile != nullptr) {
-        std::string groupName = normalizeGroup(propsFile->getGroup());
+size_t PropsFileTracker::allocateEntry(const PropsFile& propsFile) {
+    size_t entry;
+
+    if (!freeEntries_.empty()) {
+        entry = freeEntries_.back();
+        freeEntries_.pop_back();
+        entries_[entry].file_ = propsFile;
+    } else {
+        entry = entries_.size();
+        entries_.push_back(tracker::TrackedEntry{propsFile, tracker::NO_ENTRY, tracker::NO_ENTRY,
+                                                 tracker::NO_ENTRY, tracker::NO_ENTRY, false});
+    }
+
+    auto& trackedEntry = entries_[entry];
+    trackedEntry.prev_      = lastEntry_;
+    trackedEntry.next_      = tracker::NO_ENTRY;
+    trackedEntry.groupPrev_ = tracker::NO_ENTRY;
+    trackedEntry.groupNext_ = tracker::NO_ENTRY;
+    trackedEntry.used_      = true;
+
+    if (lastEntry_ != tracker::NO_ENTRY) {
+        entries_[lastEntry_].next_ = entry;
+    } else {
+        firstEntry_ = entry;
+    }
+    lastEntry_ = entry;
+    numTracked_++;
+
+    return entry;
+}
+
+/**
+ * Removes the file stored in the given slot from the
+ * tracker and its indexes, releasing the slot.
+ *
+ * @param entry the slot of the file
+ */
+void PropsFileTracker::untrackEntry(const size_t& entry) {
+    auto& trackedEntry = entries_[entry];
+
+    unlinkGroup(entry);
+    trackedMapFiles_.erase(trackedEntry.file_.getFileName());
+    if (!trackedEntry.file_.getAlias().empty()) {
+        aliasedMapFiles_.erase(trackedEntry.file_.getAlias());
+    }
+
+    if (masterFile_ == &trackedEntry.file_) {
+        masterFile_ = nullptr;
+    }
+    if (journaledMaster_ == &trackedEntry.file_) {
+        journaledMaster_ = nullptr;
+    }
+    journalRemoval(trackedEntry.file_.getFileName());
+
+    if (trackedEntry.prev_ != tracker::NO_ENTRY) {
+        entries_[trackedEntry.prev_].next_ = trackedEntry.next_;
+    } else {
+        firstEntry_ = trackedEntry.next_;
+    }
+
+    if (trackedEntry.next_ != tracker::NO_ENTRY) {
+        entries_[trackedEntry.next_].prev_ = trackedEntry.prev_;
+    } else {
+        lastEntry_ = trackedEntry.prev_;
+    }
+
+    trackedEntry.file_ = PropsFile{};
+    trackedEntry.used_ = false;
+    freeEntries_.push_back(entry);
+    numTracked_--;
+}
+
+/**
+ * Appends the file stored in the given slot to the
+ * given group, creating the group if not existing.
+ *
+ * @param entry the slot of the file
+ * @param groupName the (normalized) group name
+ */
+void PropsFileTracker::linkGroup(const size_t& entry, const std::string& groupName) {
+    auto& trackedGroup = trackedGroups_.emplace(groupName, tracker::TrackedGroup{tracker::NO_ENTRY, tracker::NO_ENTRY, 0}).first->second;
+    auto& trackedEntry = entries_[entry];
+
+    trackedEntry.groupPrev_ = trackedGroup.last_;
+    trackedEntry.groupNext_ = tracker::NO_ENTRY;
+
+    if (trackedGroup.last_ != tracker::NO_ENTRY) {
+        entries_[trackedGroup.last_].groupNext_ = entry;
+    } else {
+        trackedGroup.first_ = entry;
+    }
+    trackedGroup.last_ = entry;
+    trackedGroup.size_++;
+}
+
+/**
+ * Removes the file stored in the given slot from its
+ * group, removing the group once empty.
+ *
+ * @param entry the slot of the file
+ */
+void PropsFileTracker::unlinkGroup(const size_t& entry) {
+    auto it = trackedGroups_.find(normalizeGroup(entries_[entry].file_.getGroup()));
+
+    if (it != trackedGroups_.end()) {
+        auto& trackedGroup = it->second;
+        auto& trackedEntry = entries_[entry];
+
+        if (trackedEntry.groupPrev_ != tracker::NO_ENTRY) {
+            entries_[trackedEntry.groupPrev_].groupNext_ = trackedEntry.groupNext_;
+        } else {
+            trackedGroup.first_ = trackedEntry.groupNext_;
+        }
 
-        if ((groupName != tracker::DEFAULT_GROUP) && (trackedGroups_.count(groupName) != 0)) {
-            trackedGroups_.at(groupName).remove(propsFile);
-            propsFile->setGroup("");
+        if (trackedEntry.groupNext_ != tracker::NO_ENTRY) {
+            entries_[trackedEntry.groupNext_].groupPrev_ = trackedEntry.groupPrev_;
+        } else {
+            trackedGroup.last_ = trackedEntry.groupPrev_;
+        }
+
+        trackedEntry.groupPrev_ = tracker::NO_ENTRY;
+        trackedEntry.groupNext_ = tracker::NO_ENTRY;
+
+        if (--trackedGroup.size_ == 0) {
+            trackedGroups_.erase(it);
         }
     }
 }
@@ -665,19 +1272,13 @@ Result PropsFileTracker::group(const std::string& name, const std::string& targe
 
     if (file != nullptr) {
         if (normalizeGroup(file->getGroup()) != nTrgGroup) {
-            // Insert file in target group creating the group if not existing
-            if (trackedGroups_.count(nTrgGroup) == 0) {
-            } else {
-                trackedGroups_[nTrgGroup] = std::list<PropsFile *>{};
-            }
-            trackedGroups_[nTrgGroup].push_back(file);
+            // Switch file groups creating the target group if not existing
+            size_t entry = getEntry(file);
+            unlinkGroup(entry);
+            file->setGroup(nTrgGroup);
+            linkGroup(entry, nTrgGroup);
+            journalFile(*file);
 
-            // Switch file groups
-            const std::string &previousGroup = normalizeGroup(file->getGroup());
-            if (trackedGroups_.count(previousGroup) != 0) {
-                trackedGroups_[previousGroup].remove(file);
-                file->setGroup(nTrgGroup);
-            }
             res = save();
             if (res.isValid()) {
                 res.setMessage("File \"" + file->getFileName() + "\" moved to group \"" + (nTrgGroup == tracker::DEFAULT_GROUP ? nTrgGroup.erase(0,1) : nTrgGroup) + "\"");
@@ -707,17 +1308,23 @@ Result PropsFileTracker::removeGroup(const std::string& group, const bool& untra
     const std::string nGroup = normalizeGroup(group);
 
     if (nGroup != tracker::DEFAULT_GROUP) {
-        const std::list<PropsFile *> *groups = getGroup(nGroup);
+        auto it = trackedGroups_.find(nGroup);
 
-        if (groups != nullptr) {
-            for (auto &propsFile : *groups) {
+        if (it != trackedGroups_.end()) {
+            // The group is removed along with its last file
+            size_t entry = it->second.first_;
+            while (entry != tracker::NO_ENTRY) {
+                size_t next = entries_[entry].groupNext_;
                 if (untrack) {
-                    trackedFiles_.remove(*propsFile);
+                    untrackEntry(entry);
                 } else {
-                    propsFile->setGroup("");
+                    unlinkGroup(entry);
+                    entries_[entry].file_.setGroup("");
+                    linkGroup(entry, tracker::DEFAULT_GROUP);
+                    journalFile(entries_[entry].file_);
                 }
+                entry = next;
             }
-            trackedGroups_.erase(nGroup);
             res = res.isValid() ? save() : res;
             if (res.isValid()) {
                 res.setMessage("Group \"" + nGroup + "\" removed from tracker");
@@ -749,19 +1356,21 @@ Result PropsFileTracker::renameGroup(const std::string& sourceGroup, const std::
 
     if (nSrcGroup != tracker::DEFAULT_GROUP) {
 
-        const std::list<PropsFile *> *files = getGroup(nSrcGroup);
+        auto it = trackedGroups_.find(nSrcGroup);
 
-        if (files != nullptr) {
+        if (it != trackedGroups_.end()) {
             if (nSrcGroup != nTrgGroup) {
                 if ((trackedGroups_.count(nTrgGroup) == 0) || force) {
-                    if (trackedGroups_.count(nTrgGroup) == 0) {
-                        trackedGroups_[nTrgGroup] = std::list<PropsFile *>{};
-                    }
-                    for (auto &propsFile : *files) {
-                        propsFile->setGroup(nTrgGroup);
-                        trackedGroups_[nTrgGroup].push_back(propsFile);
+                    // The source group is removed along with its last file
+                    size_t entry = it->second.first_;
+                    while (entry != tracker::NO_ENTRY) {
+                        size_t next = entries_[entry].groupNext_;
+                        unlinkGroup(entry);
+                        entries_[entry].file_.setGroup(nTrgGroup);
+                        linkGroup(entry, nTrgGroup);
+                        journalFile(entries_[entry].file_);
+                        entry = next;
                     }
-                    trackedGroups_.erase(nSrcGroup);
                     res = save();
                     if (res.isValid()) {
                         res.setMessage("Group \"" + nSrcGroup + "\" renamed to \"" + targetGroup + "\"");
@@ -786,4 +1395,88 @@ Result PropsFileTracker::renameGroup(const std::string& sourceGroup, const std::
     return res;
 }
 
+/**
+ * Removes from the given list the files that cannot
+ * be read, warning about every skipped file.
+ *
+ * @param files the files to validate
+ */
+void PropsFileTracker::validate(std::list<PropsFile>& files) const {
+    std::vector<PropsFile*> pendingFiles;
+    pendingFiles.reserve(files.size());
+    for (auto& file : files) {
+        pendingFiles.push_back(&file);
+    }
+
+    std::vector<std::string> fullFilePaths(pendingFiles.size());
+    std::vector<char> exists(pendingFiles.size());
+    resolveFiles(pendingFiles, fullFilePaths, exists);
 
+    size_t i = 0;
+    for (auto it = files.begin(); it != files.end(); i++) {
+        if (exists[i] == 0) {
+            Result result{res::ERROR};
+            result.setSeverity(res::WARN);
+            result.setMessage("WARN: File [" + it->getFileName() + "] cannot be read.Skipping");
+            result.showMessage();
+            it = files.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * Checks that all tracked files can be read, optionally
+ * untracking the ones that cannot.
+ *
+ * @param untrack untracks the files that cannot be read
+ * @return the result of the operation
+ */
+Result PropsFileTracker::verify(const bool& untrack) {
+    Result res{res::VALID};
+
+    std::vector<PropsFile*> trackedFiles;
+    trackedFiles.reserve(numTracked_);
+    for (size_t entry = firstEntry_; entry != tracker::NO_ENTRY; entry = entries_[entry].next_) {
+        trackedFiles.push_back(&entries_[entry].file_);
+    }
+
+    std::vector<std::string> fullFilePaths(trackedFiles.size());
+    std::vector<char> exists(trackedFiles.size());
+    resolveFiles(trackedFiles, fullFilePaths, exists);
+
+    size_t numMissing = 0;
+    for (size_t i = 0; i < trackedFiles.size(); i++) {
+        if (exists[i] == 0) {
+            Result partialResult{res::ERROR};
+            partialResult.setSeverity(res::WARN);
+            partialResult.setMessage("WARN: File [" + trackedFiles[i]->getFileName() + "] cannot be read" + (untrack ? ".Untracking" : ""));
+            partialResult.showMessage();
+            if (untrack) {
+                untrackEntry(getEntry(trackedFiles[i]));
+            }
+            numMissing++;
+        }
+    }
+
+    std::string summary = "[" + std::to_string(numMissing) + "/" + std::to_string(trackedFiles.size()) + "] tracked files cannot be read";
+    if (trackedFiles.empty()) {
+        res = res::ERROR;
+        res.setSeverity(res::WARN);
+        res.setMessage("No files currently tracked");
+    } else if (numMissing == 0) {
+        res.setMessage("All tracked files can be read");
+    } else if (untrack) {
+        res = save();
+        if (res.isValid()) {
+            res.setMessage(summary + " (untracked)");
+        }
+    } else {
+        res = res::ERROR;
+        res.setSeverity(res::WARN);
+        res.setMessage(summary);
+    }
+
+    return res;
+}
@@ -18,6 +18,8 @@
 #include <props_formatter_factory.h>
 #include <props_simple_formatter.h>
 #include <props_json_formatter.h>
+#include <props_ndjson_formatter.h>
+#include <props_msgpack_formatter.h>
 
 /**
  * Default constructor.
@@ -26,6 +28,8 @@
 PropsFormatterFactory::PropsFormatterFactory() {
     formatterMap_[formatter::DEFAULT] = std::unique_ptr<PropsFormatter>(new SimplePropsFormatter());
     formatterMap_[formatter::JSON_FORMATTER] = std::unique_ptr<PropsFormatter>(new JsonPropsFormatter());
+    formatterMap_[formatter::NDJSON_FORMATTER] = std::unique_ptr<PropsFormatter>(new NdjsonPropsFormatter());
+    formatterMap_[formatter::MSGPACK_FORMATTER] = std::unique_ptr<PropsFormatter>(new MsgPackPropsFormatter());
     defaultFormatter_ = formatterMap_["DEFAULT"].get();
 }
 
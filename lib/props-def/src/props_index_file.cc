@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_index_file.h"
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <config_static.h>
+#include <file_utils.h>
+#include <props_config.h>
+
+#if defined(IS_LINUX) || defined(IS_MAC)
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Prototypes for local functions
+bool write_fully(int fd, const void* data, size_t size);
+
+/**
+ * Writes the whole buffer to the given descriptor.
+ *
+ * @param fd the file descriptor
+ * @param data the data to write
+ * @param size the size of the data
+ * @return true if written, false otherwise
+ */
+bool write_fully(int fd, const void* data, size_t size) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    auto* buffer = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, buffer, size);
+        if ((written < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        buffer += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Retrieves the path of the index file for a given properties
+ * file, stored in the index folder of the props config folder.
+ *
+ * @param fileName the absolute path to the properties file
+ * @param variant the settings the index depends on (if any)
+ * @param extension the index file extension
+ * @return the path to the index file
+ */
+std::string IndexFile::getIndexPath(const std::string& fileName, const std::string& variant, const std::string& extension) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    std::string id = fileName + '\0' + variant;
+    for (auto c : id) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream path;
+    path << config::CONFIG_FULL_PATH() << index_file::INDEX_FOLDER << ftl::pathSeparator
+         << std::hex << std::setw(16) << std::setfill('0') << hash << extension;
+    return path.str();
+}
+
+/**
+ * Writes atomically the given blocks to the index file
+ * (using a temporary file renamed once written).
+ *
+ * @param indexPath the path to the index file
+ * @param blocks the consecutive blocks to write
+ * @return true if written, false otherwise
+ */
+bool IndexFile::write(const std::string& indexPath, const std::vector<index_file::block>& blocks) {
+    bool stored = false;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    FileUtils::createDirectories(indexPath);
+
+    std::string tmpPath = indexPath + ".XXXXXX";
+    int fd = mkstemp(&tmpPath[0]);
+
+    if (fd != -1) {
+        stored = true;
+        for (auto it = blocks.begin(); stored && (it != blocks.end()); ++it) {
+            stored = write_fully(fd, it->first, it->second);
+        }
+        ::close(fd);
+
+        stored = stored && FileUtils::rename(tmpPath, indexPath);
+        if (!stored) {
+            FileUtils::remove(tmpPath);
+        }
+    }
+#endif
+    return stored;
+}
+
+/**
+ * Appends the given blocks to the end of the file
+ * (creating it if not existing).
+ *
+ * @param filePath the path to the file
+ * @param blocks the consecutive blocks to append
+ * @return true if appended, false otherwise
+ */
+bool IndexFile::append(const std::string& filePath, const std::vector<index_file::block>& blocks) {
+    bool stored = false;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    int fd = ::open(filePath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+
+    if (fd != -1) {
+        stored = true;
+        for (auto it = blocks.begin(); stored && (it != blocks.end()); ++it) {
+            stored = write_fully(fd, it->first, it->second);
+        }
+        ::close(fd);
+    }
+#endif
+    return stored;
+}
@@ -16,9 +16,11 @@
 
 
 #include <props_json_formatter.h>
-#include <string_utils.h>
+#include <props_config.h>
 
-#define SPACER "  "
+// Prototypes for local functions
+void write_options(const PropsSearchOptions& searchOptions, JsonWriter& writer);
+void write_file(const std::string& fileName, const p_search_res::MatchRange& matches, JsonWriter& writer);
 
 /**
  * Formats the given result in JSON
@@ -30,51 +32,183 @@
 void JsonPropsFormatter::format(const PropsSearchResult* result, std::ostream& out) const {
 
     if (result != nullptr) {
-        const std::string &key = result->getSearchOptions().getKey();
-        const auto &fileKeys = result->getFileKeys();
-
-        if (!fileKeys.empty()) {
-
-            // Build matches
-            long numMatches = 0;
-            std::ostringstream matches;
-            matches << StringUtils::expand(SPACER, 4) << R"("files": [{)";
-            std::string prefix;
-            // Show files
-            for (auto &fileKey : fileKeys) {
-                numMatches += fileKey.second.size();
-                matches << StringUtils::expand(SPACER, 6) << prefix << std::endl;
-                matches << StringUtils::expand(SPACER, 8) << R"("name": ")" << fileKey.first << "\"," << std::endl;
-                matches << StringUtils::expand(SPACER, 8) << R"("num_matches": )" << fileKey.second.size() << "," << std::endl;
-                matches << StringUtils::expand(SPACER, 8) << R"("matches": [{)";
-
-                // Show matches
-                prefix = "";
-                for (auto &match : fileKey.second) {
-                    matches << StringUtils::expand(SPACER, 10) << prefix << std::endl;
-                    matches << StringUtils::expand(SPACER, 12) << R"("full_match": ")" << match.fullLine_ << "\"," << std::endl;
-                    matches << StringUtils::expand(SPACER, 12) << R"("value": ")" << match.value_.str_ << "\"" << std::endl;
-                    prefix = "},\n" + StringUtils::expand(SPACER, 10) + "{";
-                }
-                matches << StringUtils::expand(SPACER, 10) << "}" << std::endl;
-                matches << StringUtils::expand(SPACER, 8) << "]" << std::endl;
-                prefix = "},\n" + StringUtils::expand(SPACER, 6) + "{";
+        if (result->getSearchOptions().isBatch()) {
+            formatBatch(result, out);
+        } else {
+            JsonResultSink sink(result->getSearchOptions(), out);
+            for (auto &fileKey : result->getFileKeys()) {
+                sink.add(*fileKey.fileName_, fileKey.matches_);
             }
+            sink.finish();
+        }
+    }
+}
+
+/**
+ * Formats the results of a batch search in JSON
+ * format grouped by term, appending to the given
+ * output stream.
+ *
+ * @param result the result
+ * @param out the output stream
+ */
+void JsonPropsFormatter::formatBatch(const PropsSearchResult* result, std::ostream& out) const {
+    const auto &batchKeys = result->getSearchOptions().getBatchKeys();
+
+    // Totals are shown first
+    std::vector<p_search_res::result_view> termResults;
+    std::vector<size_t> termMatches;
+    size_t numMatches = 0;
+    for (size_t termId = 0; termId < batchKeys.size(); termId++) {
+        termResults.push_back(result->getTermResults(termId));
+        termMatches.push_back(0);
+        for (auto &fileKey : termResults.back()) {
+            termMatches.back() += fileKey.matches_.size();
+        }
+        numMatches += termMatches.back();
+    }
+
+    JsonWriter writer(out, PropsConfig::getDefault().getValue<bool>(json_writer::KEY_COMPACT_OUTPUT, json_writer::DEFAULT_COMPACT_OUTPUT));
+    writer.beginObject();
+    writer.key("results");
+    writer.beginObject();
+    write_options(result->getSearchOptions(), writer);
+    writer.key("total_matches");
+    writer.value(numMatches);
+    writer.key("num_keys");
+    writer.value(batchKeys.size());
 
-            matches << StringUtils::expand(SPACER, 6) << "}" << std::endl;
-            matches << StringUtils::expand(SPACER, 4) << "]" << std::endl;
-
-            // Show header + matches
-            out << "{" << std::endl;
-            out << StringUtils::expand(SPACER,2)  << R"("results": {)" << std::endl;
-            out << StringUtils::expand(SPACER, 4) << R"("key": ")"<< key << "\"," << std::endl;
-            out << StringUtils::expand(SPACER, 4) << R"("type": ")"<< ((result->getSearchOptions().isMatchValue()) ? "by_value" : "by_key") << "\"," << std::endl;
-            out << StringUtils::expand(SPACER, 4) << R"("is_regex: )" << ((result->getSearchOptions().isRegex()) ? "true" : "false") << "," << std::endl;
-            out << StringUtils::expand(SPACER, 4) << R"("case_sensitive: )" << ((result->getSearchOptions().getCaseSensitive() == global_options::NO_OPT) ? "false" : "true") << "," << std::endl;
-            out << StringUtils::expand(SPACER, 4) << R"("total_matches": )" << numMatches << "," << std::endl;
-            out << StringUtils::expand(SPACER, 4) << R"("num_files": )" << fileKeys.size() << "," << std::endl;
-            out << matches.str();
-            out << StringUtils::expand(SPACER,2)  << "}\n}" << std::endl;
+    // Show the matches of every term in the order supplied
+    writer.key("keys");
+    writer.beginArray();
+    for (size_t termId = 0; termId < batchKeys.size(); termId++) {
+        writer.beginObject();
+        writer.key("key");
+        writer.value(batchKeys[termId]);
+        writer.key("total_matches");
+        writer.value(termMatches[termId]);
+        writer.key("num_files");
+        writer.value(termResults[termId].size());
+        writer.key("files");
+        writer.beginArray();
+        for (auto &fileKey : termResults[termId]) {
+            write_file(*fileKey.fileName_, fileKey.matches_, writer);
         }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.endObject();
+    writer.endObject();
+}
+
+/**
+ * Creates a sink formatting the results of a (non batch)
+ * search file by file as they are received.
+ *
+ * @param searchOptions the search options
+ * @param out the output stream
+ * @return the sink
+ */
+std::unique_ptr<PropsResultSink> JsonPropsFormatter::createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const {
+    return std::unique_ptr<PropsResultSink>(new JsonResultSink(searchOptions, out));
+}
+
+/**
+ * Writes the members describing the search options.
+ *
+ * @param searchOptions the search options
+ * @param writer the JSON writer
+ */
+void write_options(const PropsSearchOptions& searchOptions, JsonWriter& writer) {
+    writer.key("type");
+    writer.value((searchOptions.isMatchValue()) ? "by_value" : "by_key");
+    writer.key("is_regex");
+    writer.value(searchOptions.isRegex());
+    writer.key("case_sensitive");
+    writer.value(searchOptions.getCaseSensitive() != global_options::NO_OPT);
+}
+
+/**
+ * Writes the matches found in a file as an
+ * element of the JSON "files" array.
+ *
+ * @param fileName the name of the file
+ * @param matches the matches found in the file
+ * @param writer the JSON writer
+ */
+void write_file(const std::string& fileName, const p_search_res::MatchRange& matches, JsonWriter& writer) {
+    writer.beginObject();
+    writer.key("name");
+    writer.value(fileName);
+    writer.key("num_matches");
+    writer.value(matches.size());
+    writer.key("matches");
+    writer.beginArray();
+    for (auto &match : matches) {
+        writer.beginObject();
+        writer.key("full_match");
+        writer.value(match.line_);
+        writer.key("value");
+        writer.value(match.value_);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+/**
+ * Creates the sink for the given output stream.
+ *
+ * @param searchOptions the search options
+ * @param out the output stream
+ */
+JsonResultSink::JsonResultSink(PropsSearchOptions searchOptions, std::ostream& out)
+    : searchOptions_(std::move(searchOptions)),
+      writer_(out, PropsConfig::getDefault().getValue<bool>(json_writer::KEY_COMPACT_OUTPUT, json_writer::DEFAULT_COMPACT_OUTPUT)) {
+}
+
+/**
+ * Formats the matches found in a given file, writing
+ * the header of the results before the first file.
+ *
+ * @param fileName the name of the file
+ * @param matches the matches found in line order
+ */
+void JsonResultSink::add(const std::string& fileName, const p_search_res::MatchRange& matches) {
+    if (numFiles_ == 0) {
+        writer_.beginObject();
+        writer_.key("results");
+        writer_.beginObject();
+        writer_.key("key");
+        writer_.value(searchOptions_.getKey());
+        write_options(searchOptions_, writer_);
+        writer_.key("files");
+        writer_.beginArray();
+    }
+
+    write_file(fileName, matches, writer_);
+    numMatches_ += matches.size();
+    numFiles_++;
+
+    // Show every file as soon as received
+    writer_.flush();
+}
+
+/**
+ * Completes the output once all files were received
+ * writing the totals (only if any file was received).
+ */
+void JsonResultSink::finish() {
+    if (numFiles_ != 0) {
+        writer_.endArray();
+        writer_.key("total_matches");
+        writer_.value(numMatches_);
+        writer_.key("num_files");
+        writer_.value(numFiles_);
+        writer_.endObject();
+        writer_.endObject();
     }
+    writer_.flush();
 }
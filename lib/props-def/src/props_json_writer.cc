@@ -0,0 +1,304 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "props_json_writer.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Prototypes for local functions
+const char* find_escape(const char* begin, const char* end);
+
+/**
+ * Namespace for JSON escaping
+ */
+namespace json_writer {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    static const size_t DEFAULT_INDENT_LEVELS = 32;
+
+    /**
+     * Checks whether a character must be escaped inside
+     * a JSON string (quotes, backslashes and control chars).
+     *
+     * @param c the character
+     * @return true if the character must be escaped, false otherwise
+     */
+    inline bool needsEscape(const unsigned char& c) {
+        return (c < 0x20) || (c == '"') || (c == '\\');
+    }
+}
+
+/**
+ * Finds the first character requiring escaping, checking
+ * 16 characters at once when SSE2 is available.
+ *
+ * @param begin the start of the string
+ * @param end the end of the string
+ * @return the position of the character or the end if none found
+ */
+const char* find_escape(const char* begin, const char* end) {
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+
+    for (; begin + 16 <= end; begin += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        // Unsigned c <= 0x1F is the same as max(c, 0x1F) == 0x1F
+        __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, lastControl), lastControl);
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        int mask = _mm_movemask_epi8(_mm_or_si128(control, special));
+        if (mask != 0) {
+            return begin + __builtin_ctz(static_cast<unsigned int>(mask));
+        }
+    }
+#endif
+    while ((begin < end) && !json_writer::needsEscape(static_cast<unsigned char>(*begin))) {
+        begin++;
+    }
+    return begin;
+}
+
+/**
+ * Creates the writer for the given output stream.
+ *
+ * @param out the output stream
+ * @param compact true to skip the indentation, false otherwise
+ */
+JsonWriter::JsonWriter(std::ostream& out, const bool& compact)
+    : out_(out), compact_(compact), buffer_(json_writer::BUFFER_SIZE),
+      indent_(1 + json_writer::DEFAULT_INDENT_LEVELS * json_writer::INDENT_SIZE, ' ') {
+    indent_[0] = '\n';
+}
+
+/**
+ * Flushes the pending output.
+ */
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+/**
+ * Starts a new object.
+ */
+void JsonWriter::beginObject() {
+    beginElement();
+    write('{');
+    firstElement_.push_back(true);
+}
+
+/**
+ * Ends the current object.
+ */
+void JsonWriter::endObject() {
+    endScope('}');
+}
+
+/**
+ * Starts a new array.
+ */
+void JsonWriter::beginArray() {
+    beginElement();
+    write('[');
+    firstElement_.push_back(true);
+}
+
+/**
+ * Ends the current array.
+ */
+void JsonWriter::endArray() {
+    endScope(']');
+}
+
+/**
+ * Writes the name of the next member of the
+ * current object.
+ *
+ * @param name the name of the member
+ */
+void JsonWriter::key(const char* name) {
+    beginElement();
+    write('"');
+    writeEscaped(name, strlen(name));
+    write(compact_ ? "\":" : "\": ", compact_ ? 2 : 3);
+    afterKey_ = true;
+}
+
+/**
+ * Writes an escaped string value.
+ *
+ * @param value the value
+ */
+void JsonWriter::value(const pcrecpp::StringPiece& value) {
+    beginElement();
+    write('"');
+    writeEscaped(value.data(), static_cast<size_t>(value.size()));
+    write('"');
+}
+
+/**
+ * Writes a numeric value.
+ *
+ * @param value the value
+ */
+void JsonWriter::value(const size_t& value) {
+    char digits[24];
+    char* pos = digits + sizeof(digits);
+    size_t number = value;
+    do {
+        *(--pos) = static_cast<char>('0' + (number % 10));
+        number /= 10;
+    } while (number != 0);
+
+    beginElement();
+    write(pos, static_cast<size_t>(digits + sizeof(digits) - pos));
+}
+
+/**
+ * Writes a boolean value.
+ *
+ * @param value the value
+ */
+void JsonWriter::value(const bool& value) {
+    beginElement();
+    write(value ? "true" : "false", value ? 4 : 5);
+}
+
+/**
+ * Writes the buffered output to the stream
+ * and flushes the stream.
+ */
+void JsonWriter::flush() {
+    writeBuffer();
+    out_.flush();
+}
+
+/**
+ * Starts a new element of the current array or
+ * object, writing the separator from the previous one.
+ */
+void JsonWriter::beginElement() {
+    if (afterKey_) {
+        afterKey_ = false;
+    } else if (!firstElement_.empty()) {
+        if (!firstElement_.back()) {
+            write(',');
+        }
+        firstElement_.back() = false;
+        newLine();
+    }
+}
+
+/**
+ * Ends the current array or object.
+ *
+ * @param close the closing character
+ */
+void JsonWriter::endScope(const char& close) {
+    bool empty = firstElement_.back();
+    firstElement_.pop_back();
+    if (!empty) {
+        newLine();
+    }
+    write(close);
+
+    // Every document ends in its own line
+    if (firstElement_.empty()) {
+        write('\n');
+    }
+}
+
+/**
+ * Writes a line break and the indentation of
+ * the current scope (unless compact).
+ */
+void JsonWriter::newLine() {
+    if (!compact_) {
+        size_t size = 1 + firstElement_.size() * json_writer::INDENT_SIZE;
+        if (size > indent_.size()) {
+            indent_.resize(size, ' ');
+        }
+        write(indent_.data(), size);
+    }
+}
+
+/**
+ * Writes the given string escaping the characters
+ * not allowed in JSON strings.
+ *
+ * @param data the string
+ * @param size the size of the string
+ */
+void JsonWriter::writeEscaped(const char* data, size_t size) {
+    const char* end = data + size;
+    while (data < end) {
+        const char* escape = find_escape(data, end);
+        write(data, static_cast<size_t>(escape - data));
+        if (escape == end) {
+            break;
+        }
+
+        char c = *escape;
+        switch (c) {
+            case '"':  write("\\\"", 2); break;
+            case '\\': write("\\\\", 2); break;
+            case '\b': write("\\b", 2); break;
+            case '\f': write("\\f", 2); break;
+            case '\n': write("\\n", 2); break;
+            case '\r': write("\\r", 2); break;
+            case '\t': write("\\t", 2); break;
+            default:
+                char unicode[] = { '\\', 'u', '0', '0',
+                                   json_writer::HEX_DIGITS[(c >> 4) & 0x0F],
+                                   json_writer::HEX_DIGITS[c & 0x0F] };
+                write(unicode, sizeof(unicode));
+        }
+        data = escape + 1;
+    }
+}
+
+/**
+ * Appends raw data to the buffer.
+ *
+ * @param data the data
+ * @param size the size of the data
+ */
+void JsonWriter::write(const char* data, const size_t& size) {
+    if (size > buffer_.size() - size_) {
+        writeBuffer();
+    }
+
+    // Data larger than the buffer is written directly
+    if (size >= buffer_.size()) {
+        out_.write(data, static_cast<std::streamsize>(size));
+    } else {
+        memcpy(buffer_.data() + size_, data, size);
+        size_ += size;
+    }
+}
+
+/**
+ * Writes the buffered output to the stream.
+ */
+void JsonWriter::writeBuffer() {
+    if (size_ > 0) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+        size_ = 0;
+    }
+}
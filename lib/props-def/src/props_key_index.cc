@@ -0,0 +1,216 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_key_index.h"
+#include <algorithm>
+#include <cstring>
+#include <props_config.h>
+#include "props_index_file.h"
+#include "props_literal_matcher.h"
+
+/**
+ * Opens the index of the given file for the given separator,
+ * building it if not found or outdated.
+ *
+ * @param fileName the absolute path to the properties file
+ * @param separator the key/value separator
+ */
+PropsKeyIndex::PropsKeyIndex(const std::string& fileName, const std::string& separator) : separator_(separator) {
+    ftl::FileStamp stamp{};
+
+    if (FileUtils::getFileStamp(fileName, stamp)) {
+        source_.reset(new MappedFile(fileName));
+
+        // Discard the index if the file changed while being mapped
+        ftl::FileStamp mappedStamp{};
+        if (source_->isOpen() && FileUtils::getFileStamp(fileName, mappedStamp)
+            && (memcmp(&stamp, &mappedStamp, sizeof(ftl::FileStamp)) == 0)) {
+
+            indexPath_ = IndexFile::getIndexPath(fileName, separator, key_index::INDEX_EXTENSION);
+            if (!load(stamp)) {
+                build(stamp);
+            }
+            open_ = true;
+        }
+    }
+}
+
+/**
+ * Checks whether the search can be resolved using the
+ * index i.e. exact case-sensitive literal key searches where
+ * the key does not contain the separator.
+ *
+ * @param searchOptions the (already amended) search options
+ * @return true if the index can be used, false otherwise
+ */
+bool PropsKeyIndex::isSupported(const PropsSearchOptions& searchOptions) {
+    const std::string& key = searchOptions.getKey();
+    const std::string& separator = searchOptions.getSeparator();
+
+    return PropsConfig::getDefault().getValue<bool>(key_index::ENABLE_INDEX, key_index::DEFAULT_ENABLE_INDEX)
+           && !searchOptions.isBatch() && !searchOptions.isMatchValue()
+           && (searchOptions.getPartialMatch() == global_options::NO_OPT)
+           && (searchOptions.getCaseSensitive() == global_options::USE_OPT)
+           && LiteralMatcher::isSupported(searchOptions)
+           && ((key + separator).find(separator) == key.size());
+}
+
+/**
+ * Finds the lines of the properties file with the given key.
+ *
+ * @param key the key to find
+ * @param entries the entries found in line order
+ */
+void PropsKeyIndex::find(const std::string& key, std::vector<key_index::IndexEntry>& entries) const {
+    const key_index::IndexEntry* end = entries_ + numEntries_;
+    auto* it = std::lower_bound(entries_, end, key, [this](const key_index::IndexEntry& entry, const std::string& k) {
+        return compare(entry, k.data(), k.size()) < 0;
+    });
+
+    for (; (it != end) && (compare(*it, key.data(), key.size()) == 0); ++it) {
+        entries.push_back(*it);
+    }
+}
+
+/**
+ * Loads the index file if it matches the given
+ * version of the properties file.
+ *
+ * @param stamp the properties file stamp
+ * @return true if loaded, false otherwise
+ */
+bool PropsKeyIndex::load(const ftl::FileStamp& stamp) {
+    bool loaded = false;
+    index_.reset(new MappedFile(indexPath_));
+
+    if (index_->isOpen() && (index_->size() >= sizeof(key_index::IndexHeader))) {
+        const auto* header = reinterpret_cast<const key_index::IndexHeader*>(index_->data());
+        size_t entriesOffset = sizeof(key_index::IndexHeader) + IndexFile::getPaddedSize(header->separatorLength_);
+
+        loaded = (memcmp(header->magic_, key_index::INDEX_MAGIC, sizeof(header->magic_)) == 0)
+                 && (header->version_ == key_index::INDEX_VERSION)
+                 && (header->mtime_ == stamp.mtime_) && (header->size_ == stamp.size_) && (header->inode_ == stamp.inode_)
+                 && (header->separatorLength_ == separator_.size())
+                 && (index_->size() >= entriesOffset)
+                 && (header->numEntries_ == (index_->size() - entriesOffset) / sizeof(key_index::IndexEntry))
+                 && (index_->size() == entriesOffset + header->numEntries_ * sizeof(key_index::IndexEntry))
+                 && (memcmp(index_->data() + sizeof(key_index::IndexHeader), separator_.data(), separator_.size()) == 0);
+
+        if (loaded) {
+            entries_ = reinterpret_cast<const key_index::IndexEntry*>(index_->data() + entriesOffset);
+            numEntries_ = static_cast<size_t>(header->numEntries_);
+        }
+
+        // Every entry must lie within the properties file (corrupt indexes are rebuilt)
+        const size_t sourceSize = source_->size();
+        for (size_t i = 0; loaded && (i < numEntries_); i++) {
+            const auto& entry = entries_[i];
+            loaded = (entry.offset_ <= sourceSize) && (entry.lineLength_ <= sourceSize - entry.offset_)
+                     && (entry.keyLength_ <= entry.lineLength_);
+        }
+    }
+
+    if (!loaded) {
+        index_.reset();
+        entries_ = nullptr;
+        numEntries_ = 0;
+    }
+
+    return loaded;
+}
+
+/**
+ * Builds the index scanning the properties file and
+ * stores it (failing to store it is not an error).
+ *
+ * @param stamp the properties file stamp
+ */
+void PropsKeyIndex::build(const ftl::FileStamp& stamp) {
+    const char* data = source_->data();
+    const char* end = data + source_->size();
+    const size_t sepSize = separator_.size();
+
+    const char* lineStart = data;
+    while (lineStart < end) {
+        auto* eol = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart));
+        const char* lineEnd = (eol != nullptr) ? eol : end;
+        auto lineLength = static_cast<size_t>(lineEnd - lineStart);
+
+        // The key spans up to the first separator and needs a non empty value
+        if ((lineLength > 0) && (*lineStart != '#') && (lineLength <= UINT32_MAX)) {
+            const char* sep = std::search(lineStart, lineEnd, separator_.begin(), separator_.end());
+            if ((sep != lineEnd) && (sep > lineStart) && (sep + sepSize < lineEnd)) {
+                builtEntries_.push_back(key_index::IndexEntry{static_cast<uint64_t>(lineStart - data),
+                                                              static_cast<uint32_t>(sep - lineStart),
+                                                              static_cast<uint32_t>(lineLength)});
+            }
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    // Sort by key keeping the line order for duplicated keys
+    std::sort(builtEntries_.begin(), builtEntries_.end(), [this, data](const key_index::IndexEntry& a, const key_index::IndexEntry& b) {
+        int cmp = compare(a, data + b.offset_, b.keyLength_);
+        return (cmp < 0) || ((cmp == 0) && (a.offset_ < b.offset_));
+    });
+
+    entries_ = builtEntries_.data();
+    numEntries_ = builtEntries_.size();
+
+    store(stamp);
+}
+
+/**
+ * Writes the built index to the index file.
+ *
+ * @param stamp the properties file stamp
+ * @return true if written, false otherwise
+ */
+bool PropsKeyIndex::store(const ftl::FileStamp& stamp) const {
+    key_index::IndexHeader header{};
+    memcpy(header.magic_, key_index::INDEX_MAGIC, sizeof(header.magic_));
+    header.version_ = key_index::INDEX_VERSION;
+    header.separatorLength_ = static_cast<uint32_t>(separator_.size());
+    header.mtime_ = stamp.mtime_;
+    header.size_ = stamp.size_;
+    header.inode_ = stamp.inode_;
+    header.numEntries_ = numEntries_;
+
+    std::string separator = separator_;
+    separator.resize(IndexFile::getPaddedSize(separator_.size()), '\0');
+
+    return IndexFile::write(indexPath_, { index_file::block(&header, sizeof(header)),
+                                          index_file::block(separator.data(), separator.size()),
+                                          index_file::block(entries_, numEntries_ * sizeof(key_index::IndexEntry)) });
+}
+
+/**
+ * Compares the key of the given entry with a key.
+ *
+ * @param entry the index entry
+ * @param key the key
+ * @param keyLength the length of the key
+ * @return <0, 0 or >0 if the entry key is lower, equal or greater
+ */
+int PropsKeyIndex::compare(const key_index::IndexEntry& entry, const char* key, const size_t& keyLength) const {
+    size_t length = std::min(static_cast<size_t>(entry.keyLength_), keyLength);
+    int cmp = memcmp(source_->data() + entry.offset_, key, length);
+    if (cmp == 0) {
+        cmp = (entry.keyLength_ < keyLength) ? -1 : ((entry.keyLength_ > keyLength) ? 1 : 0);
+    }
+    return cmp;
+}
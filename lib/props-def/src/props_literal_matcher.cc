@@ -0,0 +1,230 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_literal_matcher.h"
+#include <cstring>
+
+/**
+ * Namespace for constants
+ */
+namespace literal {
+    static const char REGEX_META_CHARS[] = "\\^$.|?*+()[]{}";
+}
+
+/**
+ * Converts an ASCII string to lower case.
+ *
+ * @param input the input string
+ * @return the lowercase string
+ */
+std::string literal::toLower(const std::string& input) {
+    std::string output = input;
+    for (auto& c : output) {
+        c = literal::toLower(c);
+    }
+    return output;
+}
+
+/**
+ * Creates the matcher for the given (already amended) search options.
+ *
+ * @param searchOptions the search options
+ */
+LiteralMatcher::LiteralMatcher(const PropsSearchOptions& searchOptions) {
+    caseless_   = (searchOptions.getCaseSensitive() == global_options::NO_OPT);
+    partial_    = (searchOptions.getPartialMatch() == global_options::USE_OPT);
+    matchValue_ = searchOptions.isMatchValue();
+    term_       = caseless_ ? literal::toLower(searchOptions.getKey()) : searchOptions.getKey();
+    separator_  = caseless_ ? literal::toLower(searchOptions.getSeparator()) : searchOptions.getSeparator();
+
+    // The probe is the longest literal any matching line must contain
+    if (partial_) {
+        probe_ = term_;
+    } else {
+        probe_ = matchValue_ ? separator_ + term_ : term_ + separator_;
+    }
+}
+
+/**
+ * Checks whether the given search options can be resolved
+ * using a literal matcher i.e. the term is not a regular
+ * expression and the separator has no special meaning.
+ *
+ * @param searchOptions the search options
+ * @return true if a literal matcher can be used, false otherwise
+ */
+bool LiteralMatcher::isSupported(const PropsSearchOptions& searchOptions) {
+    return !searchOptions.isRegex() && !searchOptions.getKey().empty() && !searchOptions.getSeparator().empty()
+           && (searchOptions.getSeparator().find_first_of(literal::REGEX_META_CHARS) == std::string::npos);
+}
+
+/**
+ * Finds the next position in the buffer where the line
+ * containing it may match.
+ *
+ * @param begin the start of the buffer
+ * @param end the end of the buffer
+ * @return the candidate position or null if none found
+ */
+const char* LiteralMatcher::findCandidate(const char* begin, const char* end) const {
+    return find(begin, end, probe_);
+}
+
+/**
+ * Tries to match a single line reproducing the captures of the
+ * equivalent regular expression :
+ *  - Key       : ^(key)=(.+)
+ *  - Key (*)   : ^.*?(key).*?=(.+)
+ *  - Value     : ^(.+)=(value)$
+ *  - Value (*) : ^(.+)=.*?(value).*?$
+ *
+ * @param line the start of the line
+ * @param length the length of the line (without end of line)
+ * @param match the positions of the key/value matched
+ * @return true if the line matches, false otherwise
+ */
+bool LiteralMatcher::matchLine(const char* line, size_t length, literal::LineMatch& match) const {
+    const char* end = line + length;
+    const size_t termSize = term_.size();
+    const size_t sepSize = separator_.size();
+    bool matched = false;
+
+    if (!matchValue_) {
+        if (!partial_) {
+            // Key followed by separator and a non empty value
+            if ((length > termSize + sepSize) && equals(line, term_) && equals(line + termSize, separator_)) {
+                match = literal::LineMatch{0, termSize, termSize + sepSize, length - termSize - sepSize};
+                matched = true;
+            }
+        } else {
+            // First key occurrence followed by a separator and a non empty value
+            const char* key = find(line, end, term_);
+            if (key != nullptr) {
+                const char* sep = find(key + termSize, end, separator_);
+                if ((sep != nullptr) && (sep + sepSize < end)) {
+                    match = literal::LineMatch{static_cast<size_t>(key - line), termSize,
+                                               static_cast<size_t>(sep + sepSize - line),
+                                               static_cast<size_t>(end - (sep + sepSize))};
+                    matched = true;
+                }
+            }
+        }
+    } else {
+        if (!partial_) {
+            // Non empty key followed by separator and the exact value
+            if (length > termSize + sepSize) {
+                size_t valuePos = length - termSize;
+                if (equals(line + valuePos, term_) && equals(line + valuePos - sepSize, separator_)) {
+                    match = literal::LineMatch{0, valuePos - sepSize, valuePos, termSize};
+                    matched = true;
+                }
+            }
+        } else {
+            // Last separator preceding the last value occurrence
+            if (length >= termSize + sepSize + 1) {
+                const char* lastValue = rfind(line, end - termSize, term_);
+                if ((lastValue != nullptr) && (lastValue >= line + sepSize + 1)) {
+                    const char* sep = rfind(line + 1, lastValue - sepSize, separator_);
+                    if (sep != nullptr) {
+                        const char* value = find(sep + sepSize, end, term_);
+                        match = literal::LineMatch{0, static_cast<size_t>(sep - line),
+                                                   static_cast<size_t>(value - line), termSize};
+                        matched = true;
+                    }
+                }
+            }
+        }
+    }
+
+    return matched;
+}
+
+/**
+ * Finds the first occurrence of the needle in the buffer.
+ *
+ * @param begin the start of the buffer
+ * @param end the end of the buffer
+ * @param needle the text to find
+ * @return the position of the needle or null if not found
+ */
+const char* LiteralMatcher::find(const char* begin, const char* end, const std::string& needle) const {
+    const size_t needleSize = needle.size();
+    const char* found = nullptr;
+
+    if (static_cast<size_t>(end - begin) >= needleSize) {
+        const char* last = end - needleSize;
+        const char* pos = begin;
+        if (!caseless_) {
+            // Let memchr/memcmp (vectorized by the C library) do the scan
+            while ((found == nullptr) && (pos <= last)) {
+                pos = static_cast<const char*>(memchr(pos, needle[0], static_cast<size_t>(last - pos) + 1));
+                if (pos == nullptr) {
+                    break;
+                }
+                if (memcmp(pos + 1, needle.data() + 1, needleSize - 1) == 0) {
+                    found = pos;
+                }
+                pos++;
+            }
+        } else {
+            for (; (found == nullptr) && (pos <= last); pos++) {
+                if ((literal::toLower(*pos) == needle[0]) && equals(pos, needle)) {
+                    found = pos;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Finds the last occurrence of the needle starting before
+ * the given limit.
+ *
+ * @param begin the start of the buffer
+ * @param limit the last allowed start position (inclusive)
+ * @param needle the text to find
+ * @return the position of the needle or null if not found
+ */
+const char* LiteralMatcher::rfind(const char* begin, const char* limit, const std::string& needle) const {
+    const char* found = nullptr;
+    for (const char* pos = limit; (found == nullptr) && (pos >= begin); pos--) {
+        if (equals(pos, needle)) {
+            found = pos;
+        }
+    }
+    return found;
+}
+
+/**
+ * Compares the given text with the needle.
+ *
+ * @param text the text to compare
+ * @param needle the needle
+ * @return true if equal, false otherwise
+ */
+bool LiteralMatcher::equals(const char* text, const std::string& needle) const {
+    bool equal = true;
+    if (!caseless_) {
+        equal = (memcmp(text, needle.data(), needle.size()) == 0);
+    } else {
+        for (size_t i = 0; equal && (i < needle.size()); i++) {
+            equal = (literal::toLower(text[i]) == needle[i]);
+        }
+    }
+    return equal;
+}
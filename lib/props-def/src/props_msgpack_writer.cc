@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "props_msgpack_writer.h"
+#include <cstring>
+
+/**
+ * Namespace for the MessagePack format markers
+ */
+namespace msgpack_writer {
+    static const uint8_t FIXSTR     = 0xa0;
+    static const uint8_t FIXMAP     = 0x80;
+    static const uint8_t FIXARRAY   = 0x90;
+    static const uint8_t FALSE      = 0xc2;
+    static const uint8_t TRUE       = 0xc3;
+    static const uint8_t UINT8      = 0xcc;
+    static const uint8_t UINT16     = 0xcd;
+    static const uint8_t UINT32     = 0xce;
+    static const uint8_t UINT64     = 0xcf;
+    static const uint8_t STR8       = 0xd9;
+    static const uint8_t STR16      = 0xda;
+    static const uint8_t STR32      = 0xdb;
+    static const uint8_t ARRAY16    = 0xdc;
+    static const uint8_t MAP16      = 0xde;
+    static const size_t MAX_FIXSTR  = 31;
+    static const size_t MAX_FIXINT  = 127;
+    static const size_t MAX_FIXCONT = 15;
+}
+
+/**
+ * Creates the writer for the given output stream.
+ *
+ * @param out the output stream
+ */
+MsgPackWriter::MsgPackWriter(std::ostream& out) : out_(out), buffer_(msgpack_writer::BUFFER_SIZE) {
+}
+
+/**
+ * Flushes the pending output.
+ */
+MsgPackWriter::~MsgPackWriter() {
+    flush();
+}
+
+/**
+ * Starts a new map (followed by its keys and values).
+ *
+ * @param size the number of entries of the map
+ */
+void MsgPackWriter::beginMap(const size_t& size) {
+    writeContainer(msgpack_writer::FIXMAP, msgpack_writer::MAP16, size);
+}
+
+/**
+ * Starts a new array (followed by its elements).
+ *
+ * @param size the number of elements of the array
+ */
+void MsgPackWriter::beginArray(const size_t& size) {
+    writeContainer(msgpack_writer::FIXARRAY, msgpack_writer::ARRAY16, size);
+}
+
+/**
+ * Writes a string value.
+ *
+ * @param value the value
+ */
+void MsgPackWriter::value(const pcrecpp::StringPiece& value) {
+    const auto size = static_cast<size_t>(value.size());
+
+    if (size <= msgpack_writer::MAX_FIXSTR) {
+        write(static_cast<uint8_t>(msgpack_writer::FIXSTR | size));
+    } else if (size <= UINT8_MAX) {
+        writeHeader(msgpack_writer::STR8, size, 1);
+    } else if (size <= UINT16_MAX) {
+        writeHeader(msgpack_writer::STR16, size, 2);
+    } else {
+        writeHeader(msgpack_writer::STR32, size, 4);
+    }
+
+    write(value.data(), size);
+}
+
+/**
+ * Writes an unsigned integer value using the
+ * smallest encoding available.
+ *
+ * @param value the value
+ */
+void MsgPackWriter::value(const size_t& value) {
+    if (value <= msgpack_writer::MAX_FIXINT) {
+        write(static_cast<uint8_t>(value));
+    } else if (value <= UINT8_MAX) {
+        writeHeader(msgpack_writer::UINT8, value, 1);
+    } else if (value <= UINT16_MAX) {
+        writeHeader(msgpack_writer::UINT16, value, 2);
+    } else if (value <= UINT32_MAX) {
+        writeHeader(msgpack_writer::UINT32, value, 4);
+    } else {
+        writeHeader(msgpack_writer::UINT64, value, 8);
+    }
+}
+
+/**
+ * Writes a boolean value.
+ *
+ * @param value the value
+ */
+void MsgPackWriter::value(const bool& value) {
+    write(value ? msgpack_writer::TRUE : msgpack_writer::FALSE);
+}
+
+/**
+ * Writes the buffered output to the stream
+ * and flushes the stream.
+ */
+void MsgPackWriter::flush() {
+    writeBuffer();
+    out_.flush();
+}
+
+/**
+ * Writes a type marker followed by a big endian
+ * length or value of the given number of bytes.
+ *
+ * @param marker the type marker
+ * @param value the length or value
+ * @param bytes the number of bytes of the value
+ */
+void MsgPackWriter::writeHeader(const uint8_t& marker, const uint64_t& value, const size_t& bytes) {
+    char header[9];
+    header[0] = static_cast<char>(marker);
+    for (size_t i = 0; i < bytes; i++) {
+        header[bytes - i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    write(header, bytes + 1);
+}
+
+/**
+ * Writes a container header, using the fixed format
+ * when possible.
+ *
+ * @param fixMarker the marker of the fixed format
+ * @param marker16 the marker of the 16 bits format
+ * @param size the number of elements
+ */
+void MsgPackWriter::writeContainer(const uint8_t& fixMarker, const uint8_t& marker16, const size_t& size) {
+    if (size <= msgpack_writer::MAX_FIXCONT) {
+        write(static_cast<uint8_t>(fixMarker | size));
+    } else if (size <= UINT16_MAX) {
+        writeHeader(marker16, size, 2);
+    } else {
+        // The 32 bits format marker follows the 16 bits one
+        writeHeader(static_cast<uint8_t>(marker16 + 1), size, 4);
+    }
+}
+
+/**
+ * Appends raw data to the buffer.
+ *
+ * @param data the data
+ * @param size the size of the data
+ */
+void MsgPackWriter::write(const char* data, const size_t& size) {
+    if (size > buffer_.size() - size_) {
+        writeBuffer();
+    }
+
+    // Data larger than the buffer is written directly
+    if (size >= buffer_.size()) {
+        out_.write(data, static_cast<std::streamsize>(size));
+    } else {
+        memcpy(buffer_.data() + size_, data, size);
+        size_ += size;
+    }
+}
+
+/**
+ * Writes the buffered output to the stream.
+ */
+void MsgPackWriter::writeBuffer() {
+    if (size_ > 0) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+        size_ = 0;
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <props_ndjson_formatter.h>
+
+/**
+ * Formats the given result as newline delimited JSON
+ * (a single line object per match) appending to the
+ * given output stream.
+ *
+ * @param result the result
+ * @param out the output stream
+ */
+void NdjsonPropsFormatter::format(const PropsSearchResult* result, std::ostream& out) const {
+
+    if (result != nullptr) {
+        NdjsonResultSink sink(result->getSearchOptions(), out);
+
+        if (result->getSearchOptions().isBatch()) {
+            // Show the terms in the order supplied (line numbers are counted once per file)
+            const auto &batchKeys = result->getSearchOptions().getBatchKeys();
+            p_search_res::LineNumbers lineNumbers(result->getFileKeys());
+            for (size_t termId = 0; termId < batchKeys.size(); termId++) {
+                sink.setTerm(&batchKeys[termId]);
+                for (auto &fileKey : result->getTermResults(termId)) {
+                    sink.setLineNumbers(lineNumbers.get(fileKey));
+                    sink.add(*fileKey.fileName_, fileKey.matches_);
+                }
+            }
+        } else {
+            for (auto &fileKey : result->getFileKeys()) {
+                sink.add(*fileKey.fileName_, fileKey.matches_);
+            }
+        }
+
+        sink.finish();
+    }
+}
+
+/**
+ * Creates a sink formatting the results of a (non batch)
+ * search file by file as they are received.
+ *
+ * @param searchOptions the search options
+ * @param out the output stream
+ * @return the sink
+ */
+std::unique_ptr<PropsResultSink> NdjsonPropsFormatter::createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const {
+    return std::unique_ptr<PropsResultSink>(new NdjsonResultSink(searchOptions, out));
+}
+
+/**
+ * Writes the matches found in a given file. Every match holds
+ * the whole key and value of the property besides the term
+ * matched in it.
+ *
+ * @param fileName the name of the file
+ * @param matches the matches found (in line order unless their line numbers are set)
+ */
+void NdjsonResultSink::add(const std::string& fileName, const p_search_res::MatchRange& matches) {
+    p_search_res::LineCounter lineCounter;
+    const size_t separatorSize = searchOptions_.getSeparator().size();
+    const bool matchValue = searchOptions_.isMatchValue();
+
+    for (size_t i = 0; i < matches.size(); i++) {
+        const p_search_res::Match& match = matches.begin()[i];
+        const char* data = match.line_.data() - match.lineOffset_;
+        const pcrecpp::StringPiece& matched = (matchValue) ? match.value_ : match.key_;
+        p_search_res::Property property = p_search_res::getProperty(match, separatorSize, matchValue);
+
+        writer_.beginObject();
+        writer_.key("file");
+        writer_.value(fileName);
+        if (term_ != nullptr) {
+            writer_.key("term");
+            writer_.value(*term_);
+        }
+        writer_.key("line");
+        writer_.value((lineNumbers_ != nullptr) ? lineNumbers_[i] : lineCounter.getLineNumber(match));
+        writer_.key("offset");
+        writer_.value(match.lineOffset_);
+        writer_.key("key");
+        writer_.value(property.key_);
+        writer_.key("key_offset");
+        writer_.value(property.keyOffset_);
+        writer_.key("value");
+        writer_.value(property.value_);
+        writer_.key("value_offset");
+        writer_.value(property.valueOffset_);
+        writer_.key("match");
+        writer_.value(matched);
+        writer_.key("match_offset");
+        writer_.value(static_cast<size_t>(matched.data() - data));
+        writer_.endObject();
+    }
+
+    // Hand over the matches of every file as soon as received
+    writer_.flush();
+}
+
+/**
+ * Completes the output once all files were received.
+ */
+void NdjsonResultSink::finish() {
+    writer_.flush();
+}
@@ -17,188 +17,608 @@
 #include "props_reader.h"
 #include "props_search_result.h"
 #include "rang.hpp"
-#include <fstream>
 #include <sstream>
+#include <cstring>
+#include <vector>
 #include <pcrecpp.h>
 #include <file_utils.h>
+#include <mapped_file.h>
+#include <props_literal_matcher.h>
+#include <props_regex_cache.h>
+#include <props_batch_matcher.h>
+#include <props_key_index.h>
+#include <props_trigram_index.h>
+#include <props_bloom_filter.h>
+#include <props_search_scheduler.h>
 #include <props_config.h>
 #include <exec_exception.h>
-#include <thread_group.h>
-#include <deque>
+#include <thread_pool.h>
+#include <algorithm>
 
 // Prototypes for globals
-const pcrecpp::RE &COMMENTED_LINE();
-void* process_files(void* data);
-void process_file(const PropsFile* file, const search::FileSearchData* searchData);
+Result process_tasks(search::FileSearchData* searchData);
+void process_file(const PropsFile* file, const search::FileSearchData* searchData, search::FileMatches& fileMatches);
+bool may_contain_key(const std::string& fullPath, const search::FileSearchData* searchData);
+bool process_indexed_file(const std::string& fullPath, const search::FileSearchData* searchData, search::FileMatches& fileMatches);
+bool process_trigram_file(const std::string& fullPath, const search::FileSearchData* searchData, search::FileMatches& fileMatches);
+void process_range(const MappedFile& mappedFile, const scheduler::SearchTask& task, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches);
+const char* find_line_start(const char* data, const char* dataEnd, const size_t& offset);
+void process_buffer(const char* data, const char* begin, const char* end, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches);
+void process_literal_buffer(const char* data, const char* begin, const char* end, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches);
+void process_batch_buffer(const char* data, const char* begin, const char* end, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches);
+p_search_res::Match build_match(const size_t& termId, const char* data, const char* lineStart, const size_t& lineLength, const literal::LineMatch& lineMatch);
 
 /**
  * Namespace for reader
  */
 namespace reader {
-    static const long DEFAULT_MAX_WORKER_THREADS = 5;
-    static const char* MAX_WORKER_THREADS = "general.max_worker_threads";
+    static const long DEFAULT_CHUNK_SIZE = 32L * 1024 * 1024;
+    static const char* CHUNK_SIZE = "search.chunk_size";
 }
 
-// Controls the file queue access
-pthread_mutex_t filesQueueMutex;
+/**
+ * Process the search tasks assigned to the worker (stealing
+ * them from other workers when done) finding potential matches
+ * for the search terms provided. Every range keeps its matches
+ * in its own buffer, written by a single thread, which is handed
+ * over once the range is notified as done.
+ * 
+ * @param searchData the search tasks and search terms
+ * @return the result of the operation
+ */
+Result process_tasks(search::FileSearchData* searchData) {
+    Result result{res::VALID};
+
+    if (searchData != nullptr) {
+        SearchScheduler* scheduler = searchData->scheduler_;
+        search::SearchProgress* progress = searchData->progress_;
+
+        size_t worker = scheduler->registerWorker();
+        scheduler::SearchTask task{};
+        bool aborted = false;
+
+        while (!aborted && scheduler->next(worker, task)) {
+            const PropsFile& file = searchData->files_->at(task.fileIndex_);
+            const MappedFile* mappedFile = searchData->mappedFiles_->at(task.fileIndex_).get();
+            search::FileMatches& fileMatches = searchData->fileMatches_->at(task.fileIndex_);
+
+            try {
+                // Only the files split in ranges are mapped beforehand
+                if (mappedFile != nullptr) {
+                    process_range(*mappedFile, task, searchData, fileMatches.ranges_[task.rangeIndex_]);
+                } else {
+                    process_file(&file, searchData, fileMatches);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(progress->mutex_);
+                progress->aborted_ = true;
+                progress->rangeDone_.notify_one();
+                throw;
+            }
+
+            std::lock_guard<std::mutex> lock(progress->mutex_);
+            fileMatches.pendingRanges_--;
+            progress->rangeDone_.notify_one();
+            aborted = progress->aborted_;
+        }
+    }
+
+    return result;
+}
 
 /**
- * Retrieves the regular expression for
- * commented lines.
+ * Process a single file applying the given search data.
  *
- * @return the regex for commented lines
+ * @param file the file to process
+ * @param searchData the search data
+ * @param fileMatches the matches found in line order
  */
-const pcrecpp::RE &COMMENTED_LINE() {
-    static const pcrecpp::RE COMMENTED_LINE("^#");
-    return COMMENTED_LINE;
+void process_file(const PropsFile* file, const search::FileSearchData* searchData, search::FileMatches& fileMatches) {
+    if (file != nullptr) {
+        const std::string &fullPath = FileUtils::getAbsolutePath(file->getFileName());
+
+        // Skip files which cannot contain the key
+        if (searchData->useBloomFilter_ && !may_contain_key(fullPath, searchData)) {
+            return;
+        }
+
+        // Exact key lookups may skip the scan
+        if (searchData->useIndex_ && process_indexed_file(fullPath, searchData, fileMatches)) {
+            return;
+        }
+
+        // Substring lookups may only check the lines with the required trigrams
+        if (!searchData->trigramLiterals_.empty() && process_trigram_file(fullPath, searchData, fileMatches)) {
+            return;
+        }
+
+        auto mappedFile = std::make_shared<const MappedFile>(fullPath);
+
+        if (mappedFile->isOpen()) {
+            const char* data = mappedFile->data();
+            process_buffer(data, data, data + mappedFile->size(), searchData, fileMatches.ranges_[0]);
+            fileMatches.source_ = mappedFile;
+        } else {
+            std::cerr << rang::fgB::red << "File \"" << file->getFileName() << "\" not found" << rang::fg::reset
+                      << std::endl;
+        }
+    }
 }
 
 /**
- * Process a file queue finding potential matches for
- * the search terms provided.
- * 
- * @param data the files queue and search terms
- * @return the result of the operation
+ * Checks the Bloom filter of the file (building it first if
+ * needed) to find out if the searched key may be present.
+ *
+ * @param fullPath the absolute path of the file
+ * @param searchData the search data
+ * @return false if the file does not contain the key, true otherwise
  */
-void* process_files(void* data) {
-    auto* result = new Result{res::VALID};
-    bool keep_processing = true;
+bool may_contain_key(const std::string& fullPath, const search::FileSearchData* searchData) {
+    PropsBloomFilter bloomFilter(fullPath, searchData->searchOptions_->getSeparator());
+    return !bloomFilter.isOpen() || bloomFilter.mayContain(searchData->searchOptions_->getKey());
+}
 
-    if (data != nullptr) {
-        auto *searchData = (search::FileSearchData*) data;
-        auto *filesQueue = searchData->filesQueue_;
+/**
+ * Process a single file looking up the key in its key index
+ * (building the index first if needed).
+ *
+ * @param fullPath the absolute path of the file
+ * @param searchData the search data
+ * @param fileMatches the matches found in line order
+ * @return true if the index was available, false otherwise
+ */
+bool process_indexed_file(const std::string& fullPath, const search::FileSearchData* searchData, search::FileMatches& fileMatches) {
+    PropsSearchOptions* searchOptions = searchData->searchOptions_;
+    const size_t sepSize = searchOptions->getSeparator().size();
+
+    PropsKeyIndex keyIndex(fullPath, searchOptions->getSeparator());
+    if (keyIndex.isOpen()) {
+        std::vector<key_index::IndexEntry> entries;
+        keyIndex.find(searchOptions->getKey(), entries);
+
+        for (auto& entry : entries) {
+            const char* line = keyIndex.getData() + entry.offset_;
+            size_t valuePos = entry.keyLength_ + sepSize;
+            fileMatches.ranges_[0].push_back(p_search_res::Match{0,
+                                                               entry.offset_,
+                                                               pcrecpp::StringPiece(line, static_cast<int>(entry.lineLength_)),
+                                                               pcrecpp::StringPiece(line, static_cast<int>(entry.keyLength_)),
+                                                               pcrecpp::StringPiece(line + valuePos, static_cast<int>(entry.lineLength_ - valuePos))});
+        }
 
+        if (!entries.empty()) {
+            fileMatches.source_ = keyIndex.getSource();
+        }
+    }
 
-        while (keep_processing) {
-            pthread_mutex_lock (&filesQueueMutex);
+    return keyIndex.isOpen();
+}
 
-            std::unique_ptr<PropsFile> file;
+/**
+ * Process a single file matching only the lines containing the
+ * trigrams of the search literals (building the index first if needed).
+ *
+ * @param fullPath the absolute path of the file
+ * @param searchData the search data
+ * @param fileMatches the matches found in line order
+ * @return true if the index was available, false otherwise
+ */
+bool process_trigram_file(const std::string& fullPath, const search::FileSearchData* searchData, search::FileMatches& fileMatches) {
+    PropsTrigramIndex trigramIndex(fullPath);
+    if (trigramIndex.isOpen()) {
+        std::vector<trigram_index::IndexLine> lines;
+        trigramIndex.find(searchData->trigramLiterals_, lines);
+
+        for (auto& line : lines) {
+            const char* lineStart = trigramIndex.getData() + line.offset_;
+            process_buffer(trigramIndex.getData(), lineStart, lineStart + line.length_, searchData, fileMatches.ranges_[0]);
+        }
 
-            if (!filesQueue->empty()) {
-                file.reset(new PropsFile(filesQueue->back()));
-                filesQueue->pop_back();
-            } else {
-                keep_processing = false;
-            }
+        if (!fileMatches.ranges_[0].empty()) {
+            fileMatches.source_ = trigramIndex.getSource();
+        }
+    }
 
-            pthread_mutex_unlock(&filesQueueMutex);
+    return trigramIndex.isOpen();
+}
 
-            process_file(file.get(), searchData);
+/**
+ * Process a range of a large file. The range includes
+ * the lines starting within its bounds.
+ *
+ * @param mappedFile the mapped file
+ * @param task the range to process
+ * @param searchData the search data
+ * @param matches the matches found in line order
+ */
+void process_range(const MappedFile& mappedFile, const scheduler::SearchTask& task, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches) {
+    const char* data = mappedFile.data();
+    const char* dataEnd = data + mappedFile.size();
+    const char* begin = find_line_start(data, dataEnd, task.begin_);
+    const char* end = find_line_start(data, dataEnd, task.end_);
+
+    if (begin < end) {
+        process_buffer(data, begin, end, searchData, matches);
+    }
+}
 
+/**
+ * Finds the first line starting at or after the given offset.
+ *
+ * @param data the start of the buffer
+ * @param dataEnd the end of the buffer
+ * @param offset the offset in the buffer
+ * @return the start of the line or the end of the buffer if none found
+ */
+const char* find_line_start(const char* data, const char* dataEnd, const size_t& offset) {
+    const char* lineStart = dataEnd;
+    if (offset == 0) {
+        lineStart = data;
+    } else if (offset < static_cast<size_t>(dataEnd - data)) {
+        auto* eol = static_cast<const char*>(memchr(data + offset - 1, '\n', dataEnd - (data + offset - 1)));
+        lineStart = (eol != nullptr) ? eol + 1 : dataEnd;
+    }
+    return lineStart;
+}
 
-        }
+/**
+ * Finds the matches in the lines of the given buffer.
+ *
+ * @param data the start of the file (to compute the line offsets)
+ * @param begin the start of the buffer (at a line start)
+ * @param end the end of the buffer
+ * @param searchData the search data
+ * @param matches the matches found in line order
+ */
+void process_buffer(const char* data, const char* begin, const char* end, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches) {
+    if (searchData->batchMatcher_ != nullptr) {
+        process_batch_buffer(data, begin, end, searchData, matches);
+        return;
+    }
+
+    if (searchData->literalMatcher_ != nullptr) {
+        process_literal_buffer(data, begin, end, searchData, matches);
+        return;
     }
 
-    pthread_exit(result);
+    const PropsRegex* regex = searchData->regex_.get();
+    pcrecpp::StringPiece value_k;
+    pcrecpp::StringPiece value_r;
+
+    const char* lineStart = begin;
+    while (lineStart < end) {
+        auto* eol = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart));
+        const char* lineEnd = (eol != nullptr) ? eol : end;
+        pcrecpp::StringPiece line(lineStart, static_cast<int>(lineEnd - lineStart));
+
+        // Try to find the regex in line, and keep results.
+        if ((line.empty()) || (line[0] != '#')) {
+            if (regex->match(line, &value_k, &value_r)) {
+                matches.push_back(p_search_res::Match{0, static_cast<size_t>(lineStart - data), line, value_k, value_r});
+            }
+        }
+
+        lineStart = lineEnd + 1;
+    }
 }
 
 /**
- * Process a single file applying the given search data.
+ * Finds the matches in the lines of the given buffer using the
+ * literal matcher. Only the lines containing the literal probe
+ * are inspected, the rest of the buffer is skipped.
  *
- * @param file the file to process
+ * @param data the start of the file (to compute the line offsets)
+ * @param begin the start of the buffer (at a line start)
+ * @param end the end of the buffer
  * @param searchData the search data
+ * @param matches the matches found in line order
  */
-void process_file(const PropsFile* file, const search::FileSearchData* searchData) {
-    if (file != nullptr) {
-        PropsSearchOptions* searchOptions = searchData->searchOptions_;
-        auto* regex = (pcrecpp::RE*)searchData->regex_;
-        const std::string &input = searchOptions->getKey();
-        pcrecpp::StringPiece value_k;
-        pcrecpp::StringPiece value_r;
+void process_literal_buffer(const char* data, const char* begin, const char* end, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches) {
+    const LiteralMatcher* matcher = searchData->literalMatcher_;
+    literal::LineMatch lineMatch{};
+
+    const char* pos = begin;
+    while (pos < end) {
+        const char* candidate = matcher->findCandidate(pos, end);
+        if (candidate == nullptr) {
+            break;
+        }
 
-        const std::string &fullPath = FileUtils::getAbsolutePath(file->getFileName());
-        std::ifstream infile(fullPath);
-
-        if (infile) {
-            // TODO: Process dividing file in chunks and in parallel (mmap ?)
-            std::string line;
-            while (std::getline(infile, line)) {
-                // Try to find the regex in line, and keep results.
-                if (!COMMENTED_LINE().PartialMatch(line)) {
-                    if (regex->PartialMatch(line, &value_k, &value_r)) {
-                        size_t pos_k = value_k.data() - line.data();
-                        size_t pos_r = value_r.data() - line.data();
-                        searchData->searchResult_->add(file->getFileName(), p_search_res::Match{input,
-                                                                                   *(searchOptions),
-                                                                                   line,
-                                                                                   p_search_res::StringMatch{value_k.as_string(), pos_k},
-                                                                                   p_search_res::StringMatch{value_r.as_string(),pos_r}});
-                    }
-                }
+        // Expand the candidate to its enclosing line
+        const char* lineStart = candidate;
+        while ((lineStart > begin) && (*(lineStart - 1) != '\n')) {
+            lineStart--;
+        }
+        auto* eol = static_cast<const char*>(memchr(candidate, '\n', end - candidate));
+        const char* lineEnd = (eol != nullptr) ? eol : end;
+        auto lineLength = static_cast<size_t>(lineEnd - lineStart);
+
+        if ((*lineStart != '#') && matcher->matchLine(lineStart, lineLength, lineMatch)) {
+            matches.push_back(build_match(0, data, lineStart, lineLength, lineMatch));
+        }
+
+        pos = lineEnd + 1;
+    }
+}
+
+/**
+ * Finds the matches of all the batch terms in the lines of
+ * the given buffer. Matches of every line are kept in term order.
+ *
+ * @param data the start of the file (to compute the line offsets)
+ * @param begin the start of the buffer (at a line start)
+ * @param end the end of the buffer
+ * @param searchData the search data
+ * @param matches the matches found in line order
+ */
+void process_batch_buffer(const char* data, const char* begin, const char* end, const search::FileSearchData* searchData, std::vector<p_search_res::Match>& matches) {
+    const BatchMatcher* matcher = searchData->batchMatcher_;
+    std::vector<batch::BatchHit> hits;
+
+    const char* lineStart = begin;
+    while (lineStart < end) {
+        auto* eol = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart));
+        const char* lineEnd = (eol != nullptr) ? eol : end;
+        auto lineLength = static_cast<size_t>(lineEnd - lineStart);
+
+        if ((lineLength > 0) && (*lineStart != '#')) {
+            hits.clear();
+            matcher->matchLine(lineStart, lineLength, hits);
+
+            for (auto& hit : hits) {
+                matches.push_back(build_match(hit.term_, data, lineStart, lineLength, hit.match_));
             }
-            infile.close();
-        } else {
-            std::cerr << rang::fgB::red << "File \"" << file->getFileName() << "\" not found" << rang::fg::reset
-                      << std::endl;
         }
+
+        lineStart = lineEnd + 1;
     }
 }
 
 /**
- * Finds the value for the key in the specified file.
+ * Builds a match referencing the line of the buffer
+ * and the key/value positions found in it.
+ *
+ * @param termId the index of the term matched
+ * @param data the start of the file (to compute the line offset)
+ * @param lineStart the start of the line
+ * @param lineLength the length of the line
+ * @param lineMatch the positions of the key/value in the line
+ * @return the match
+ */
+p_search_res::Match build_match(const size_t& termId, const char* data, const char* lineStart, const size_t& lineLength, const literal::LineMatch& lineMatch) {
+    return p_search_res::Match{termId,
+                               static_cast<size_t>(lineStart - data),
+                               pcrecpp::StringPiece(lineStart, static_cast<int>(lineLength)),
+                               pcrecpp::StringPiece(lineStart + lineMatch.keyPos_, static_cast<int>(lineMatch.keyLength_)),
+                               pcrecpp::StringPiece(lineStart + lineMatch.valuePos_, static_cast<int>(lineMatch.valueLength_))};
+}
+
+/**
+ * Finds the value for the key in the specified file. The matches
+ * of every file are sent to the sink (if supplied) as soon as the
+ * file is searched instead of being kept in the result.
  *
  * @param key the key to search
  * @param file the source file
+ * @param sink the sink receiving the matches file by file
  * @return the value for the key in the file
  */
-std::unique_ptr<PropsSearchResult> PropsReader::processSearch(PropsSearchOptions &searchOptions, const std::list<PropsFile> &files) {
+std::unique_ptr<PropsSearchResult> PropsReader::processSearch(PropsSearchOptions &searchOptions, const std::list<PropsFile> &files, PropsResultSink* sink) {
+    // Configure threading
+    ThreadPool& threadPool = ThreadPool::getDefault();
+    size_t maxWorkerThreads = threadPool.getNumThreads();
+    auto chunkSize = PropsConfig::getDefault().getValue<size_t>(reader::CHUNK_SIZE, reader::DEFAULT_CHUNK_SIZE);
+    chunkSize = (chunkSize > 0) ? chunkSize : reader::DEFAULT_CHUNK_SIZE;
+
+    // Amend options if defaults needed
+    fixSearchOptions(searchOptions);
     std::unique_ptr<PropsSearchResult> searchResult(new PropsSearchResult(searchOptions));
-    search::FileSearchData fileSearchData = buildSearchData(searchOptions, files);
+    bool useIndex = PropsKeyIndex::isSupported(searchOptions);
+
+    std::vector<std::string> trigramLiterals;
+    if (!useIndex && !searchOptions.isBatch()
+        && PropsConfig::getDefault().getValue<bool>(trigram_index::ENABLE_INDEX, trigram_index::DEFAULT_ENABLE_INDEX)) {
+        PropsTrigramIndex::getRequiredLiterals(searchOptions, trigramLiterals);
+    }
+
+    search::FileSearchData fileSearchData = buildSearchData(searchOptions);
     fileSearchData.searchResult_ = searchResult.get();
+    fileSearchData.useIndex_ = useIndex;
+    fileSearchData.useBloomFilter_ = PropsBloomFilter::isSupported(searchOptions);
+    fileSearchData.trigramLiterals_ = trigramLiterals;
+
+    // Large files are split in ranges (unless indexed), the rest are searched whole.
+    // Streamed files are searched in the order their results are handed over (by name)
+    // so the first results are not delayed by larger files later in the list, the rest
+    // largest first so the largest ones do not make the tail of the search.
+    std::vector<PropsFile> searchFiles(files.begin(), files.end());
+    std::stable_sort(searchFiles.begin(), searchFiles.end(), [](const PropsFile& a, const PropsFile& b) {
+        return a.getFileName() < b.getFileName();
+    });
+    std::vector<std::shared_ptr<const MappedFile>> mappedFiles(searchFiles.size());
+    std::vector<search::FileMatches> fileMatches(searchFiles.size());
+    std::vector<scheduler::SearchTask> tasks;
+    for (size_t i = 0; i < searchFiles.size(); i++) {
+        const std::string &fullPath = FileUtils::getAbsolutePath(searchFiles[i].getFileName());
+        size_t fileSize = FileUtils::getFileSize(fullPath);
+        bool isLarge = !useIndex && trigramLiterals.empty() && (maxWorkerThreads > 1) && (fileSize > chunkSize);
+        size_t numTasks = tasks.size();
+
+        if (!isLarge) {
+            tasks.push_back(scheduler::SearchTask{i, 0, 0, fileSize});
+        } else if (!fileSearchData.useBloomFilter_ || may_contain_key(fullPath, &fileSearchData)) {
+            mappedFiles[i] = std::make_shared<const MappedFile>(fullPath);
+            if (mappedFiles[i]->isOpen()) {
+                size_t mappedSize = mappedFiles[i]->size();
+                for (size_t begin = 0; begin < mappedSize; begin += chunkSize) {
+                    tasks.push_back(scheduler::SearchTask{i, begin / chunkSize, begin, std::min(begin + chunkSize, mappedSize)});
+                }
+            } else {
+                std::cerr << rang::fgB::red << "File \"" << searchFiles[i].getFileName() << "\" not found" << rang::fg::reset
+                          << std::endl;
+            }
+        }
 
-    // Configure threading
-    auto maxWorkerThreads = PropsConfig::getDefault().getValue<size_t>(reader::MAX_WORKER_THREADS, reader::DEFAULT_MAX_WORKER_THREADS);
-    maxWorkerThreads = (maxWorkerThreads > files.size()) ? files.size() : maxWorkerThreads;
+        numTasks = tasks.size() - numTasks;
+        fileMatches[i].ranges_.resize(numTasks);
+        fileMatches[i].pendingRanges_ = numTasks;
+    }
 
-    pthread_mutex_init(&filesQueueMutex, nullptr);
+    if (!tasks.empty()) {
+        auto numThreads = (maxWorkerThreads > tasks.size()) ? tasks.size() : maxWorkerThreads;
 
-    ThreadGroup threadGroup("READER_GROUP_SEARCH", maxWorkerThreads);
-    threadGroup.setThreadFunction(process_files);
-    threadGroup.setData(&fileSearchData);
-    threadGroup.start();
-    threadGroup.wait();
+        SearchScheduler scheduler(numThreads);
+        scheduler.schedule(tasks, sink == nullptr);
 
-    // free search resources
-    pthread_mutex_destroy(&filesQueueMutex);
+        search::SearchProgress progress;
+        progress.aborted_ = false;
+        fileSearchData.files_ = &searchFiles;
+        fileSearchData.mappedFiles_ = &mappedFiles;
+        fileSearchData.scheduler_ = &scheduler;
+        fileSearchData.fileMatches_ = &fileMatches;
+        fileSearchData.progress_ = &progress;
+
+        std::vector<std::future<Result>> workers;
+        try {
+            for (size_t i = 0; i < numThreads; i++) {
+                workers.push_back(threadPool.submit([&fileSearchData]() { return process_tasks(&fileSearchData); }));
+            }
+
+            // Hand over the files in order as soon as all their ranges are searched
+            std::vector<const std::vector<p_search_res::Match>*> ranges;
+            std::vector<p_search_res::Match> buffer;
+            for (size_t first = 0, last = 0; first < searchFiles.size(); first = last) {
+
+                // Files supplied more than once are handed over together
+                const std::string& fileName = searchFiles[first].getFileName();
+                last = first + 1;
+                while ((last < searchFiles.size()) && (searchFiles[last].getFileName() == fileName)) {
+                    last++;
+                }
+
+                std::unique_lock<std::mutex> lock(progress.mutex_);
+                progress.rangeDone_.wait(lock, [&]() {
+                    return progress.aborted_ || std::all_of(fileMatches.begin() + first, fileMatches.begin() + last,
+                                                            [](const search::FileMatches& file) { return file.pendingRanges_ == 0; });
+                });
+                if (progress.aborted_) {
+                    break;
+                }
+                lock.unlock();
+
+                ranges.clear();
+                for (size_t i = first; i < last; i++) {
+                    for (auto& range : fileMatches[i].ranges_) {
+                        ranges.push_back(&range);
+                    }
+                }
+
+                if (sink != nullptr) {
+                    // The matches are handed over contiguous
+                    const std::vector<p_search_res::Match>* matches = (ranges.size() == 1) ? ranges.front() : &buffer;
+                    if (ranges.size() != 1) {
+                        buffer.clear();
+                        for (auto* range : ranges) {
+                            buffer.insert(buffer.end(), range->begin(), range->end());
+                        }
+                    }
+                    if (!matches->empty()) {
+                        sink->add(fileName, p_search_res::MatchRange(matches->data(), matches->data() + matches->size()));
+                    }
+                } else {
+                    for (size_t i = first; i < last; i++) {
+                        const std::shared_ptr<const MappedFile>& source = (mappedFiles[i] != nullptr) ? mappedFiles[i] : fileMatches[i].source_;
+                        bool hasMatches = std::any_of(fileMatches[i].ranges_.begin(), fileMatches[i].ranges_.end(),
+                                                      [](const std::vector<p_search_res::Match>& range) { return !range.empty(); });
+                        if ((source != nullptr) && hasMatches) {
+                            searchResult->addSource(source);
+                        }
+                    }
+                    searchResult->add(fileName, ranges);
+                }
 
-    delete fileSearchData.filesQueue_;
-    delete (pcrecpp::RE*)fileSearchData.regex_;
+                // Release the buffers and mapped contents of the files handed over
+                for (size_t i = first; i < last; i++) {
+                    fileMatches[i] = search::FileMatches{nullptr, {}, 0};
+                    mappedFiles[i].reset();
+                }
+            }
+        } catch (...) {
+            // The workers reference the search state of this call, stop them before unwinding
+            {
+                std::lock_guard<std::mutex> lock(progress.mutex_);
+                progress.aborted_ = true;
+            }
+            for (auto& worker : workers) {
+                worker.wait();
+            }
+            throw;
+        }
+
+        for (auto& worker : workers) {
+            worker.wait();
+        }
+        for (auto& worker : workers) {
+            worker.get();
+        }
+
+        fileSearchData.scheduler_ = nullptr;
+        fileSearchData.fileMatches_ = nullptr;
+        fileSearchData.progress_ = nullptr;
+    }
+
+    // free search resources
+    delete fileSearchData.literalMatcher_;
+    delete fileSearchData.batchMatcher_;
 
     return searchResult;
 }
 
 /**
- * Retrieves the search data for the given options and file list.
+ * Retrieves the search data for the given options.
  *
  * @param searchOptions the search options
- * @param files the list of files to process
  * @return the built search data
  */
-search::FileSearchData PropsReader::buildSearchData(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files) {
+search::FileSearchData PropsReader::buildSearchData(PropsSearchOptions& searchOptions) {
 
-    // Amend options if defaults needed
-    fixSearchOptions(searchOptions);
+    // Plain terms are matched without regular expressions
+    std::shared_ptr<const PropsRegex> regex;
+    LiteralMatcher* literalMatcher = nullptr;
+    BatchMatcher* batchMatcher = nullptr;
 
-    // Regex options
-    pcrecpp::RE_Options opt;
-    opt.set_caseless((searchOptions.getCaseSensitive() == global_options::NO_OPT));
+    if (searchOptions.isBatch()) {
+        batchMatcher = new BatchMatcher(searchOptions, compileRegex);
+    } else if (LiteralMatcher::isSupported(searchOptions)) {
+        literalMatcher = new LiteralMatcher(searchOptions);
+    } else {
+        regex = compileRegex(searchOptions);
+    }
 
-    // Build regex
+    return search::FileSearchData { &searchOptions, regex, literalMatcher, batchMatcher, false, false, {}, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+}
+
+/**
+ * Retrieves the compiled regular expression for the given
+ * search options (reusing an already compiled one if possible).
+ *
+ * @param searchOptions the search options
+ * @return the compiled regular expression
+ */
+std::shared_ptr<const PropsRegex> PropsReader::compileRegex(const PropsSearchOptions& searchOptions) {
     std::string regex_in;
     buildRegex(searchOptions, regex_in);
-    auto* regex = new pcrecpp::RE(regex_in, opt);
 
-    if (regex->NumberOfCapturingGroups() > 2) {
-        throw ExecutionException("Too many capture groups specified");
-    }
+    auto regex = PropsRegexCache::getDefault().get(regex_in,
+                                                   (searchOptions.getCaseSensitive() == global_options::NO_OPT),
+                                                   searchOptions.getSeparator(),
+                                                   (searchOptions.getPartialMatch() == global_options::USE_OPT));
 
-    // Fill the queue with input files
-    auto* pFilesQueue = new std::deque<PropsFile>();
-    for (auto& file : files) {
-        pFilesQueue->push_back(file);
+    if (regex->getNumberOfCapturingGroups() > 2) {
+        throw ExecutionException("Too many capture groups specified");
     }
 
-    return search::FileSearchData { &searchOptions, regex, pFilesQueue, nullptr };
+    return regex;
 }
 
 /**
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_regex.h"
+#include <exec_exception.h>
+
+/**
+ * Namespace for constants
+ */
+namespace regex {
+    static const int JIT_STACK_START_SIZE = 32 * 1024;
+    static const int JIT_STACK_MAX_SIZE = 1024 * 1024;
+    static const int OVECTOR_SIZE = 9;
+}
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+// Prototypes for local functions
+pcre_jit_stack* get_jit_stack(void* data);
+
+/**
+ * Holds the JIT stack of the current thread. JIT stacks
+ * cannot be shared by concurrent matches so every
+ * worker thread gets its own one.
+ */
+typedef struct JitStackHolder {
+    pcre_jit_stack* stack_{nullptr};
+
+    ~JitStackHolder() {
+        if (stack_ != nullptr) {
+            pcre_jit_stack_free(stack_);
+        }
+    }
+} JitStackHolder;
+
+/**
+ * Retrieves (allocating it on first use) the
+ * JIT stack of the current thread.
+ *
+ * @param data unused
+ * @return the JIT stack for the current thread
+ */
+pcre_jit_stack* get_jit_stack(void* /*data*/) {
+    static thread_local JitStackHolder holder;
+    if (holder.stack_ == nullptr) {
+        holder.stack_ = pcre_jit_stack_alloc(regex::JIT_STACK_START_SIZE, regex::JIT_STACK_MAX_SIZE);
+    }
+    return holder.stack_;
+}
+#endif
+
+/**
+ * Compiles the given pattern.
+ *
+ * @param pattern the regular expression
+ * @param caseless the flag enabling case insensitive matching
+ * @param useJit the flag enabling JIT compilation (if supported)
+ * @throws ExecutionException if the pattern is not valid
+ */
+PropsRegex::PropsRegex(const std::string& pattern, bool caseless, bool useJit) {
+    const char* error = nullptr;
+    int errorOffset = 0;
+
+    code_ = pcre_compile(pattern.c_str(), (caseless) ? PCRE_CASELESS : 0, &error, &errorOffset, nullptr);
+    if (code_ == nullptr) {
+        throw ExecutionException(std::string("Invalid regular expression : ") + ((error != nullptr) ? error : pattern));
+    }
+
+    int studyOptions = 0;
+#ifdef PCRE_STUDY_JIT_COMPILE
+    if (useJit) {
+        studyOptions |= PCRE_STUDY_JIT_COMPILE;
+    }
+#else
+    (void) useJit;
+#endif
+
+    // Study errors are not fatal, matching just falls back to the interpreter
+    extra_ = pcre_study(code_, studyOptions, &error);
+    pcre_fullinfo(code_, extra_, PCRE_INFO_CAPTURECOUNT, &captureCount_);
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+    int jit = 0;
+    if ((extra_ != nullptr) && (pcre_fullinfo(code_, extra_, PCRE_INFO_JIT, &jit) == 0) && (jit == 1)) {
+        jit_ = true;
+        pcre_assign_jit_stack(extra_, get_jit_stack, nullptr);
+    }
+#endif
+}
+
+/**
+ * Releases the compiled pattern.
+ */
+PropsRegex::~PropsRegex() {
+    if (extra_ != nullptr) {
+        pcre_free_study(extra_);
+    }
+    pcre_free(code_);
+}
+
+/**
+ * Tries to match the pattern in the given text retrieving
+ * the first two capturing groups.
+ *
+ * @param text the text to match
+ * @param key the first group matched
+ * @param value the second group matched
+ * @return true if the text matches, false otherwise
+ */
+bool PropsRegex::match(const pcrecpp::StringPiece& text, pcrecpp::StringPiece* key, pcrecpp::StringPiece* value) const {
+    int ovector[regex::OVECTOR_SIZE];
+    int rc = pcre_exec(code_, extra_, text.data(), text.size(), 0, 0, ovector, regex::OVECTOR_SIZE);
+
+    if (rc >= 0) {
+        pcrecpp::StringPiece* groups[] = { key, value };
+        for (int i = 0; i < 2; i++) {
+            int group = i + 1;
+            if ((group < rc) && (ovector[2 * group] >= 0)) {
+                groups[i]->set(text.data() + ovector[2 * group], ovector[2 * group + 1] - ovector[2 * group]);
+            } else {
+                groups[i]->clear();
+            }
+        }
+    }
+
+    return (rc >= 0);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_regex_cache.h"
+#include <props_config.h>
+
+/**
+ * Default constructor.
+ * Reads the maximum number of patterns to keep.
+ */
+PropsRegexCache::PropsRegexCache() {
+    capacity_ = PropsConfig::getDefault().getValue<size_t>(regex_cache::CACHE_SIZE, regex_cache::DEFAULT_CACHE_SIZE);
+}
+
+/**
+ * Retrieves the compiled pattern for the given search
+ * terms, compiling it on a cache miss.
+ *
+ * @param pattern the regular expression
+ * @param caseless the flag enabling case insensitive matching
+ * @param separator the key/value separator the pattern was built with
+ * @param partial the partial match flag the pattern was built with
+ * @return the compiled pattern
+ * @throws ExecutionException if the pattern is not valid
+ */
+std::shared_ptr<const PropsRegex> PropsRegexCache::get(const std::string& pattern, bool caseless, const std::string& separator, bool partial) {
+    std::string key = pattern;
+    key.append(1, '\0').append(separator).append(1, '\0').append(caseless ? "i" : "").append(partial ? "p" : "");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        // Move to the front as the most recently used
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    std::shared_ptr<const PropsRegex> regex(new PropsRegex(pattern, caseless));
+
+    if (capacity_ > 0) {
+        entries_.emplace_front(key, regex);
+        index_[key] = entries_.begin();
+
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    return regex;
+}
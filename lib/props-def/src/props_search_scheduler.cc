@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "props_search_scheduler.h"
+#include <algorithm>
+
+/**
+ * Creates the scheduler for the given number of workers.
+ *
+ * @param numWorkers the number of workers
+ */
+SearchScheduler::SearchScheduler(const size_t& numWorkers) : nextWorker_(0) {
+    for (size_t i = 0; i < std::max<size_t>(numWorkers, 1); i++) {
+        queues_.emplace_back(new WorkerQueue());
+    }
+}
+
+/**
+ * Distributes the tasks among the worker queues, largest first
+ * or keeping their order (so tasks are taken in the given order).
+ * Tasks are dealt in turns so every worker starts with one of
+ * the largest ones (or workers progress together through the list).
+ *
+ * @param tasks the tasks to distribute
+ * @param largestFirst the flag to sort the tasks largest first
+ */
+void SearchScheduler::schedule(std::vector<scheduler::SearchTask> tasks, const bool& largestFirst) {
+    if (largestFirst) {
+        std::stable_sort(tasks.begin(), tasks.end(), [](const scheduler::SearchTask& a, const scheduler::SearchTask& b) {
+            return (a.end_ - a.begin_) > (b.end_ - b.begin_);
+        });
+    }
+
+    for (size_t i = 0; i < tasks.size(); i++) {
+        WorkerQueue& queue = *queues_[i % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        queue.tasks_.push_back(tasks[i]);
+    }
+}
+
+/**
+ * Assigns a queue to the calling worker.
+ *
+ * @return the worker identifier
+ */
+size_t SearchScheduler::registerWorker() {
+    return nextWorker_++ % queues_.size();
+}
+
+/**
+ * Retrieves the next task of the worker, stealing
+ * it from another worker if its queue is empty.
+ *
+ * @param worker the worker identifier
+ * @param task the next task
+ * @return true if a task was found, false if all queues are empty
+ */
+bool SearchScheduler::next(const size_t& worker, scheduler::SearchTask& task) {
+    bool found = false;
+    for (size_t i = 0; !found && (i < queues_.size()); i++) {
+        found = take(*queues_[(worker + i) % queues_.size()], task);
+    }
+    return found;
+}
+
+/**
+ * Takes the first task of the given queue.
+ *
+ * @param queue the queue
+ * @param task the task taken
+ * @return true if the queue had any task, false otherwise
+ */
+bool SearchScheduler::take(WorkerQueue& queue, scheduler::SearchTask& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex_);
+    bool found = !queue.tasks_.empty();
+    if (found) {
+        task = queue.tasks_.front();
+        queue.tasks_.pop_front();
+    }
+    return found;
+}
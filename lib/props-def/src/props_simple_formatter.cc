@@ -16,9 +16,57 @@
 
 
 #include <props_simple_formatter.h>
-#include <string_utils.h>
 #include <props_config.h>
 #include <props_reader.h>
+#include "rang.hpp"
+
+// Prototypes for local functions
+bool is_highlight_enabled();
+bool is_colored(std::ostream& out);
+template <typename T> std::string get_escape(const T& value);
+
+/**
+ * Checks whether the matched terms are highlighted,
+ * reading the configuration only once.
+ *
+ * @return true if highlighting is enabled, false otherwise
+ */
+bool is_highlight_enabled() {
+    static const bool enableHighlight = PropsConfig::getDefault().getValue<bool>(search::KEY_ENABLE_HIGHLIGHT, search::DEFAULT_ENABLE_HIGHLIGHT);
+    return enableHighlight;
+}
+
+/**
+ * Checks whether the styles written to the given
+ * stream are applied (i.e. the stream is a terminal
+ * supporting colors unless forced).
+ *
+ * @param out the output stream
+ * @return true if styles are applied, false otherwise
+ */
+bool is_colored(std::ostream& out) {
+    const rang::control mode = rang::rang_implementation::controlMode();
+    return (mode == rang::control::Force)
+           || ((mode == rang::control::Auto) && rang::rang_implementation::supportsColor()
+               && rang::rang_implementation::isTerminal(out.rdbuf()));
+}
+
+/**
+ * Retrieves the escape sequence of the given style or color.
+ *
+ * @param value the style or color
+ * @return the escape sequence
+ */
+template <typename T>
+std::string get_escape(const T& value) {
+    std::ostringstream out;
+
+    rang::setControlMode(rang::control::Force);
+    out << value;
+    rang::setControlMode(rang::control::Auto);
+
+    return out.str();
+}
 
 /**
  * Formats the given result appending
@@ -31,27 +79,128 @@ void SimplePropsFormatter::format(const PropsSearchResult* result, std::ostream&
 
     if (result != nullptr) {
 
-        const auto &fileKeys = result->getFileKeys();
-
-        bool enableHighlight = PropsConfig::getDefault().getValue<bool>(search::KEY_ENABLE_HIGHLIGHT, search::DEFAULT_ENABLE_HIGHLIGHT);
-
-        if (!fileKeys.empty()) {
-            for (auto &fileKey : fileKeys) {
-                out << std::endl << rang::style::bold << rang::fgB::green << fileKey.first << rang::style::reset
-                    << std::endl;
-                int i = 1;
-                for (auto &match : fileKey.second) {
-                    const std::string& match_str = (enableHighlight)
-                        ? StringUtils::highlight(match.fullLine_,
-                                ((match.searchOptions_.isMatchValue()) ? match.value_.str_ : match.key_.str_),
-                                ((match.searchOptions_.isMatchValue()) ? match.value_.position : match.key_.position))
-                        : match.fullLine_;
-
-                    out << rang::style::bold << rang::fgB::yellow << i << rang::style::reset << ":"
-                        << match_str << std::endl;
-                    i++;
+        SimpleResultSink sink(is_highlight_enabled(), result->getSearchOptions().isMatchValue(), out);
+
+        if (result->getSearchOptions().isBatch()) {
+            // Show the terms found in the order supplied
+            const auto &batchKeys = result->getSearchOptions().getBatchKeys();
+            for (size_t termId = 0; termId < batchKeys.size(); termId++) {
+                const auto &fileKeys = result->getTermResults(termId);
+                if (!fileKeys.empty()) {
+                    out << std::endl << rang::style::bold << rang::fgB::magenta << batchKeys[termId] << rang::style::reset << std::endl;
+                    for (auto &fileKey : fileKeys) {
+                        sink.add(*fileKey.fileName_, fileKey.matches_);
+                    }
                 }
             }
+        } else {
+            for (auto &fileKey : result->getFileKeys()) {
+                sink.add(*fileKey.fileName_, fileKey.matches_);
+            }
+        }
+
+        sink.finish();
+    }
+}
+
+/**
+ * Creates a sink formatting the results of a (non batch)
+ * search file by file as they are received.
+ *
+ * @param searchOptions the search options
+ * @param out the output stream
+ * @return the sink
+ */
+std::unique_ptr<PropsResultSink> SimplePropsFormatter::createSink(const PropsSearchOptions& searchOptions, std::ostream& out) const {
+    return std::unique_ptr<PropsResultSink>(new SimpleResultSink(is_highlight_enabled(), searchOptions.isMatchValue(), out));
+}
+
+/**
+ * Creates the sink for the given output stream.
+ *
+ * @param enableHighlight the flag to highlight the matched term
+ * @param matchValue the flag to highlight the value instead of the key
+ * @param out the output stream
+ */
+SimpleResultSink::SimpleResultSink(const bool& enableHighlight, const bool& matchValue, std::ostream& out)
+    : enableHighlight_(enableHighlight), matchValue_(matchValue), out_(out) {
+
+    // File names and line numbers are only styled on terminals
+    if (is_colored(out)) {
+        fileStyle_  = get_escape(rang::style::bold) + get_escape(rang::fgB::green);
+        lineStyle_  = get_escape(rang::style::bold) + get_escape(rang::fgB::yellow);
+        resetStyle_ = get_escape(rang::style::reset);
+    }
+
+    // Matched terms are always highlighted (if enabled)
+    if (enableHighlight_) {
+        highlightStyle_ = get_escape(rang::style::reversed) + get_escape(rang::fgB::yellow);
+        highlightReset_ = get_escape(rang::style::reset);
+    }
+
+    buffer_.reserve(simple_formatter::BUFFER_SIZE);
+}
+
+/**
+ * Formats the matches found in a given file.
+ *
+ * @param fileName the name of the file
+ * @param matches the matches found in line order
+ */
+void SimpleResultSink::add(const std::string& fileName, const p_search_res::MatchRange& matches) {
+    buffer_.append(1, '\n').append(fileStyle_).append(fileName).append(resetStyle_).append(1, '\n');
+
+    size_t i = 1;
+    for (auto &match : matches) {
+        buffer_.append(lineStyle_).append(std::to_string(i)).append(resetStyle_).append(1, ':');
+        writeLine(match.line_, (matchValue_) ? match.value_ : match.key_);
+        buffer_.append(1, '\n');
+        i++;
+
+        if (buffer_.size() >= simple_formatter::BUFFER_SIZE) {
+            writeBuffer();
         }
     }
+
+    // Hand over the matches of every file as soon as received
+    writeBuffer();
+    out_.flush();
+}
+
+/**
+ * Completes the output once all files were received.
+ */
+void SimpleResultSink::finish() {
+    writeBuffer();
+    out_.flush();
+}
+
+/**
+ * Appends the given line to the buffer highlighting
+ * the matched term.
+ *
+ * @param line the line
+ * @param term the matched term (inside the line)
+ */
+void SimpleResultSink::writeLine(const pcrecpp::StringPiece& line, const pcrecpp::StringPiece& term) {
+    if (enableHighlight_) {
+        const char* termEnd = term.data() + term.size();
+        buffer_.append(line.data(), static_cast<size_t>(term.data() - line.data()))
+               .append(highlightStyle_)
+               .append(term.data(), static_cast<size_t>(term.size()))
+               .append(highlightReset_)
+               .append(termEnd, static_cast<size_t>(line.data() + line.size() - termEnd));
+    } else {
+        buffer_.append(line.data(), static_cast<size_t>(line.size()));
+    }
+}
+
+/**
+ * Writes the buffered output to the stream.
+ */
+void SimpleResultSink::writeBuffer() {
+    if (!buffer_.empty()) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
 }
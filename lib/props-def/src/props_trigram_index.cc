@@ -0,0 +1,558 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "props_trigram_index.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+#include <props_config.h>
+#include "props_index_file.h"
+#include "props_literal_matcher.h"
+
+// Prototypes for local functions
+uint32_t get_trigram(const char* text);
+void get_line_trigrams(const char* line, const size_t& length, std::vector<uint32_t>& trigrams);
+bool is_optional_quantifier(const std::string& regex, const size_t& pos);
+size_t skip_quantifier(const std::string& regex, size_t pos);
+size_t skip_class(const std::string& regex, size_t pos);
+size_t find_group_end(const std::string& regex, size_t pos);
+
+/**
+ * Namespace for constants
+ */
+namespace trigram_index {
+    // Escaped letters matching a single (non literal) character or an assertion
+    static const char CLASS_ESCAPES[] = "dDwWsSbBAzZGhHvVRXntrfea";
+}
+
+/**
+ * Retrieves the trigram starting at the given (lowercased) text.
+ *
+ * @param text the text
+ * @return the trigram
+ */
+uint32_t get_trigram(const char* text) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(text[0])) << 16)
+           | (static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8)
+           | static_cast<uint32_t>(static_cast<unsigned char>(text[2]));
+}
+
+/**
+ * Retrieves the distinct (lowercased) trigrams of the given line.
+ *
+ * @param line the start of the line
+ * @param length the length of the line
+ * @param trigrams the trigrams in ascending order
+ */
+void get_line_trigrams(const char* line, const size_t& length, std::vector<uint32_t>& trigrams) {
+    trigrams.clear();
+    if (length >= trigram_index::TRIGRAM_SIZE) {
+        char text[trigram_index::TRIGRAM_SIZE] = { literal::toLower(line[0]), literal::toLower(line[1]), 0 };
+        for (size_t i = trigram_index::TRIGRAM_SIZE - 1; i < length; i++) {
+            text[2] = literal::toLower(line[i]);
+            trigrams.push_back(get_trigram(text));
+            text[0] = text[1];
+            text[1] = text[2];
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    }
+}
+
+/**
+ * Checks whether the quantifier at the given position (if any)
+ * allows zero repetitions of the preceding atom.
+ *
+ * @param regex the regular expression
+ * @param pos the position following the atom
+ * @return true if the atom is optional, false otherwise
+ */
+bool is_optional_quantifier(const std::string& regex, const size_t& pos) {
+    bool optional = false;
+    if (pos < regex.size()) {
+        char q = regex[pos];
+        optional = (q == '?') || (q == '*') || ((q == '{') && (pos + 1 < regex.size()) && (regex[pos + 1] == '0'));
+    }
+    return optional;
+}
+
+/**
+ * Skips the quantifier at the given position (if any)
+ * including the lazy/possessive modifiers.
+ *
+ * @param regex the regular expression
+ * @param pos the position following the atom
+ * @return the position following the quantifier
+ */
+size_t skip_quantifier(const std::string& regex, size_t pos) {
+    if (pos < regex.size()) {
+        char q = regex[pos];
+        if ((q == '?') || (q == '*') || (q == '+')) {
+            pos++;
+        } else if ((q == '{') && (pos + 1 < regex.size()) && isdigit(regex[pos + 1])) {
+            size_t end = regex.find('}', pos);
+            pos = (end != std::string::npos) ? end + 1 : regex.size();
+        } else {
+            return pos;
+        }
+        if ((pos < regex.size()) && ((regex[pos] == '?') || (regex[pos] == '+'))) {
+            pos++;
+        }
+    }
+    return pos;
+}
+
+/**
+ * Skips the character class starting at the given position.
+ *
+ * @param regex the regular expression
+ * @param pos the position of the opening bracket
+ * @return the position following the class or npos if not closed
+ */
+size_t skip_class(const std::string& regex, size_t pos) {
+    pos++;
+    if ((pos < regex.size()) && (regex[pos] == '^')) {
+        pos++;
+    }
+    if ((pos < regex.size()) && (regex[pos] == ']')) {
+        pos++;
+    }
+    while ((pos < regex.size()) && (regex[pos] != ']')) {
+        if (regex[pos] == '\\') {
+            pos += 2;
+        } else if ((regex[pos] == '[') && (pos + 1 < regex.size()) && (regex[pos + 1] == ':')) {
+            size_t end = regex.find(":]", pos + 2);
+            pos = (end != std::string::npos) ? end + 2 : regex.size();
+        } else {
+            pos++;
+        }
+    }
+    return (pos < regex.size()) ? pos + 1 : std::string::npos;
+}
+
+/**
+ * Finds the end of the group starting at the given position.
+ *
+ * @param regex the regular expression
+ * @param pos the position of the opening parenthesis
+ * @return the position of the closing parenthesis or npos if not closed
+ */
+size_t find_group_end(const std::string& regex, size_t pos) {
+    int depth = 0;
+    while (pos < regex.size()) {
+        char c = regex[pos];
+        if (c == '\\') {
+            pos += 2;
+            continue;
+        }
+        if (c == '[') {
+            pos = skip_class(regex, pos);
+            if (pos == std::string::npos) {
+                break;
+            }
+            continue;
+        }
+        if (c == '(') {
+            depth++;
+        } else if ((c == ')') && (--depth == 0)) {
+            return pos;
+        }
+        pos++;
+    }
+    return std::string::npos;
+}
+
+/**
+ * Opens the trigram index of the given file,
+ * building it if not found or outdated.
+ *
+ * @param fileName the absolute path to the properties file
+ */
+PropsTrigramIndex::PropsTrigramIndex(const std::string& fileName) {
+    ftl::FileStamp stamp{};
+
+    if (FileUtils::getFileStamp(fileName, stamp)) {
+        source_.reset(new MappedFile(fileName));
+
+        // Discard the index if the file changed while being mapped
+        ftl::FileStamp mappedStamp{};
+        if (source_->isOpen() && FileUtils::getFileStamp(fileName, mappedStamp)
+            && (memcmp(&stamp, &mappedStamp, sizeof(ftl::FileStamp)) == 0)) {
+
+            indexPath_ = IndexFile::getIndexPath(fileName, "", trigram_index::INDEX_EXTENSION);
+            open_ = load(stamp) || build(stamp);
+        }
+    }
+}
+
+/**
+ * Retrieves the (lowercased) literals every line matching the
+ * search must contain. Only literals long enough to have trigrams
+ * are retrieved, so no literals means the index cannot be used.
+ *
+ * @param searchOptions the (already amended) search options
+ * @param literals the required literals
+ */
+void PropsTrigramIndex::getRequiredLiterals(const PropsSearchOptions& searchOptions, std::vector<std::string>& literals) {
+    std::vector<std::string> required;
+
+    if (!searchOptions.isRegex()) {
+        if ((searchOptions.getPartialMatch() == global_options::NO_OPT) && LiteralMatcher::isSupported(searchOptions)) {
+            // The separator is adjacent to the term
+            required.push_back(searchOptions.isMatchValue() ? searchOptions.getSeparator() + searchOptions.getKey()
+                                                            : searchOptions.getKey() + searchOptions.getSeparator());
+        } else {
+            required.push_back(searchOptions.getKey());
+        }
+    } else if (!extractLiterals(searchOptions.getKey(), required)) {
+        required.clear();
+    }
+
+    for (auto& literal : required) {
+        if (literal.size() >= trigram_index::TRIGRAM_SIZE) {
+            literals.push_back(literal::toLower(literal));
+        }
+    }
+}
+
+/**
+ * Finds the lines containing all trigrams of the given literals.
+ *
+ * @param literals the required literals
+ * @param lines the candidate lines in line order
+ */
+void PropsTrigramIndex::find(const std::vector<std::string>& literals, std::vector<trigram_index::IndexLine>& lines) const {
+    std::vector<uint32_t> trigrams;
+    for (auto& literal : literals) {
+        for (size_t i = 0; i + trigram_index::TRIGRAM_SIZE <= literal.size(); i++) {
+            trigrams.push_back(get_trigram(literal.data() + i));
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    std::vector<const trigram_index::TrigramEntry*> entries;
+    for (auto& trigram : trigrams) {
+        const trigram_index::TrigramEntry* entry = findTrigram(trigram);
+        if (entry == nullptr) {
+            return;
+        }
+        entries.push_back(entry);
+    }
+
+    if (entries.empty()) {
+        return;
+    }
+
+    // Intersect starting with the shortest lists
+    std::sort(entries.begin(), entries.end(), [](const trigram_index::TrigramEntry* a, const trigram_index::TrigramEntry* b) {
+        return a->count_ < b->count_;
+    });
+
+    std::vector<uint32_t> candidates(postings_ + entries[0]->start_, postings_ + entries[0]->start_ + entries[0]->count_);
+    std::vector<uint32_t> intersection;
+    for (size_t i = 1; (i < entries.size()) && !candidates.empty(); i++) {
+        const uint32_t* postings = postings_ + entries[i]->start_;
+        intersection.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), postings, postings + entries[i]->count_,
+                              std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+
+    for (auto& line : candidates) {
+        lines.push_back(lines_[line]);
+    }
+}
+
+/**
+ * Extracts the literals any match of the given regular expression
+ * must contain. Alternations and unknown constructs are not analyzed.
+ *
+ * @param regex the regular expression
+ * @param literals the required literals
+ * @return true if the expression could be analyzed, false otherwise
+ */
+bool PropsTrigramIndex::extractLiterals(const std::string& regex, std::vector<std::string>& literals) {
+    std::string run;
+    size_t pos = 0;
+
+    auto flush = [&run, &literals]() {
+        if (!run.empty()) {
+            literals.push_back(run);
+            run.clear();
+        }
+    };
+
+    while (pos < regex.size()) {
+        char c = regex[pos];
+        char literal = c;
+        bool isLiteral = false;
+        size_t next = pos + 1;
+
+        if (c == '\\') {
+            if (pos + 1 >= regex.size()) {
+                return false;
+            }
+            char e = regex[pos + 1];
+            next = pos + 2;
+            if (!isalnum(static_cast<unsigned char>(e))) {
+                literal = e;
+                isLiteral = true;
+            } else if (strchr(trigram_index::CLASS_ESCAPES, e) == nullptr) {
+                // Back references, code points, properties...
+                return false;
+            }
+        } else if (c == '[') {
+            next = skip_class(regex, pos);
+            if (next == std::string::npos) {
+                return false;
+            }
+        } else if (c == '(') {
+            size_t end = find_group_end(regex, pos);
+            if ((end == std::string::npos) || ((pos + 1 < regex.size()) && (regex[pos + 1] == '?')
+                                               && ((pos + 2 >= regex.size()) || (regex[pos + 2] != ':')))) {
+                return false;
+            }
+            flush();
+            if (is_optional_quantifier(regex, end + 1)) {
+                // Nothing inside an optional group is required
+                pos = skip_quantifier(regex, end + 1);
+            } else {
+                pos = (regex[pos + 1] == '?') ? pos + 3 : pos + 1;
+            }
+            continue;
+        } else if (c == ')') {
+            flush();
+            pos = skip_quantifier(regex, pos + 1);
+            continue;
+        } else if (c == '|') {
+            return false;
+        } else {
+            isLiteral = (c != '.') && (c != '^') && (c != '$');
+        }
+
+        if (!isLiteral) {
+            flush();
+            pos = skip_quantifier(regex, next);
+        } else if (is_optional_quantifier(regex, next)) {
+            flush();
+            pos = skip_quantifier(regex, next);
+        } else {
+            run.push_back(literal);
+            pos = skip_quantifier(regex, next);
+            if (pos != next) {
+                // Repeated character, the run cannot go on
+                flush();
+            }
+        }
+    }
+
+    flush();
+    return true;
+}
+
+/**
+ * Loads the index file if it matches the given
+ * version of the properties file.
+ *
+ * @param stamp the properties file stamp
+ * @return true if loaded, false otherwise
+ */
+bool PropsTrigramIndex::load(const ftl::FileStamp& stamp) {
+    bool loaded = false;
+    index_.reset(new MappedFile(indexPath_));
+
+    if (index_->isOpen() && (index_->size() >= sizeof(trigram_index::IndexHeader))) {
+        const auto* header = reinterpret_cast<const trigram_index::IndexHeader*>(index_->data());
+        const uint64_t available = index_->size() - sizeof(trigram_index::IndexHeader);
+
+        // The counts are checked against the index size before computing any offset (no overflows)
+        loaded = (memcmp(header->magic_, trigram_index::INDEX_MAGIC, sizeof(header->magic_)) == 0)
+                 && (header->version_ == trigram_index::INDEX_VERSION)
+                 && (header->mtime_ == stamp.mtime_) && (header->size_ == stamp.size_) && (header->inode_ == stamp.inode_)
+                 && (header->numLines_ <= available / sizeof(trigram_index::IndexLine))
+                 && (header->numTrigrams_ <= (available - header->numLines_ * sizeof(trigram_index::IndexLine)) / sizeof(trigram_index::TrigramEntry));
+
+        if (loaded) {
+            size_t linesOffset = sizeof(trigram_index::IndexHeader);
+            size_t trigramsOffset = linesOffset + header->numLines_ * sizeof(trigram_index::IndexLine);
+            size_t postingsOffset = trigramsOffset + header->numTrigrams_ * sizeof(trigram_index::TrigramEntry);
+            size_t postingsSize = index_->size() - postingsOffset;
+
+            loaded = (header->numPostings_ == postingsSize / sizeof(uint32_t)) && (postingsSize % sizeof(uint32_t) == 0);
+            if (loaded) {
+                lines_ = reinterpret_cast<const trigram_index::IndexLine*>(index_->data() + linesOffset);
+                trigrams_ = reinterpret_cast<const trigram_index::TrigramEntry*>(index_->data() + trigramsOffset);
+                postings_ = reinterpret_cast<const uint32_t*>(index_->data() + postingsOffset);
+                numLines_ = static_cast<size_t>(header->numLines_);
+                numTrigrams_ = static_cast<size_t>(header->numTrigrams_);
+                numPostings_ = static_cast<size_t>(header->numPostings_);
+            }
+        }
+
+        // Every line must lie within the properties file (corrupt indexes are rebuilt)
+        const size_t sourceSize = source_->size();
+        for (size_t i = 0; loaded && (i < numLines_); i++) {
+            loaded = (lines_[i].offset_ <= sourceSize) && (lines_[i].length_ <= sourceSize - lines_[i].offset_);
+        }
+
+        // Every trigram must be sorted and list sorted lines within the postings
+        for (size_t i = 0; loaded && (i < numTrigrams_); i++) {
+            const trigram_index::TrigramEntry& entry = trigrams_[i];
+            loaded = ((i == 0) || (trigrams_[i - 1].trigram_ < entry.trigram_))
+                     && (entry.start_ <= numPostings_) && (entry.count_ <= numPostings_ - entry.start_);
+
+            for (size_t j = 0; loaded && (j < entry.count_); j++) {
+                const uint32_t line = postings_[entry.start_ + j];
+                loaded = (line < numLines_) && ((j == 0) || (postings_[entry.start_ + j - 1] < line));
+            }
+        }
+    }
+
+    if (!loaded) {
+        index_.reset();
+        lines_ = nullptr;
+        trigrams_ = nullptr;
+        postings_ = nullptr;
+        numLines_ = 0;
+        numTrigrams_ = 0;
+        numPostings_ = 0;
+    }
+
+    return loaded;
+}
+
+/**
+ * Builds the index scanning the properties file and stores it
+ * (failing to store it is not an error). The postings are counted
+ * first and then filled in place so no intermediate list of
+ * trigram/line pairs is kept. Indexes exceeding the memory limit
+ * are not built (the file is then scanned).
+ *
+ * @param stamp the properties file stamp
+ * @return true if built, false otherwise
+ */
+bool PropsTrigramIndex::build(const ftl::FileStamp& stamp) {
+    const char* data = source_->data();
+    const char* end = data + source_->size();
+
+    // Postings by trigram (counts first, then insertion positions)
+    std::unordered_map<uint32_t, uint64_t> postings;
+    std::vector<uint32_t> lineTrigrams;
+    uint64_t numPostings = 0;
+
+    const char* lineStart = data;
+    while (lineStart < end) {
+        auto* eol = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart));
+        const char* lineEnd = (eol != nullptr) ? eol : end;
+        auto lineLength = static_cast<size_t>(lineEnd - lineStart);
+
+        if ((lineLength > 0) && (*lineStart != '#') && (lineLength <= UINT32_MAX) && (builtLines_.size() < UINT32_MAX)) {
+            builtLines_.push_back(trigram_index::IndexLine{static_cast<uint64_t>(lineStart - data), static_cast<uint32_t>(lineLength), 0});
+
+            get_line_trigrams(lineStart, lineLength, lineTrigrams);
+            for (auto& trigram : lineTrigrams) {
+                postings[trigram]++;
+            }
+            numPostings += lineTrigrams.size();
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    auto maxMemory = PropsConfig::getDefault().getValue<size_t>(trigram_index::MAX_MEMORY, trigram_index::DEFAULT_MAX_MEMORY);
+    uint64_t memory = builtLines_.size() * sizeof(trigram_index::IndexLine)
+                      + postings.size() * sizeof(trigram_index::TrigramEntry) + numPostings * sizeof(uint32_t);
+
+    if (memory > maxMemory) {
+        std::vector<trigram_index::IndexLine>().swap(builtLines_);
+        return false;
+    }
+
+    // Lay out the postings of every trigram in trigram order
+    builtTrigrams_.reserve(postings.size());
+    for (auto& posting : postings) {
+        builtTrigrams_.push_back(trigram_index::TrigramEntry{posting.first, static_cast<uint32_t>(posting.second), 0});
+    }
+    std::sort(builtTrigrams_.begin(), builtTrigrams_.end(), [](const trigram_index::TrigramEntry& a, const trigram_index::TrigramEntry& b) {
+        return a.trigram_ < b.trigram_;
+    });
+
+    uint64_t start = 0;
+    for (auto& trigram : builtTrigrams_) {
+        trigram.start_ = start;
+        postings[trigram.trigram_] = start;
+        start += trigram.count_;
+    }
+
+    // Lines are visited in order so every list is already sorted
+    builtPostings_.resize(numPostings);
+    for (size_t lineId = 0; lineId < builtLines_.size(); lineId++) {
+        get_line_trigrams(data + builtLines_[lineId].offset_, builtLines_[lineId].length_, lineTrigrams);
+        for (auto& trigram : lineTrigrams) {
+            builtPostings_[postings[trigram]++] = static_cast<uint32_t>(lineId);
+        }
+    }
+
+    lines_ = builtLines_.data();
+    trigrams_ = builtTrigrams_.data();
+    postings_ = builtPostings_.data();
+    numLines_ = builtLines_.size();
+    numTrigrams_ = builtTrigrams_.size();
+    numPostings_ = builtPostings_.size();
+
+    store(stamp);
+    return true;
+}
+
+/**
+ * Writes the built index to the index file.
+ *
+ * @param stamp the properties file stamp
+ * @return true if written, false otherwise
+ */
+bool PropsTrigramIndex::store(const ftl::FileStamp& stamp) const {
+    trigram_index::IndexHeader header{};
+    memcpy(header.magic_, trigram_index::INDEX_MAGIC, sizeof(header.magic_));
+    header.version_ = trigram_index::INDEX_VERSION;
+    header.mtime_ = stamp.mtime_;
+    header.size_ = stamp.size_;
+    header.inode_ = stamp.inode_;
+    header.numLines_ = numLines_;
+    header.numTrigrams_ = numTrigrams_;
+    header.numPostings_ = numPostings_;
+
+    return IndexFile::write(indexPath_, { index_file::block(&header, sizeof(header)),
+                                          index_file::block(lines_, numLines_ * sizeof(trigram_index::IndexLine)),
+                                          index_file::block(trigrams_, numTrigrams_ * sizeof(trigram_index::TrigramEntry)),
+                                          index_file::block(postings_, numPostings_ * sizeof(uint32_t)) });
+}
+
+/**
+ * Finds the entry of the given trigram.
+ *
+ * @param trigram the trigram
+ * @return the entry or null if no line contains it
+ */
+const trigram_index::TrigramEntry* PropsTrigramIndex::findTrigram(const uint32_t& trigram) const {
+    const trigram_index::TrigramEntry* end = trigrams_ + numTrigrams_;
+    auto* it = std::lower_bound(trigrams_, end, trigram, [](const trigram_index::TrigramEntry& entry, const uint32_t& t) {
+        return entry.trigram_ < t;
+    });
+    return ((it != end) && (it->trigram_ == trigram)) ? it : nullptr;
+}
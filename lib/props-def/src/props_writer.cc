@@ -0,0 +1,657 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "props_writer.h"
+#include "props_reader.h"
+#include "config_static.h"
+#include <file_utils.h>
+#include <props_config.h>
+#include <thread_pool.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(IS_LINUX) || defined(IS_MAC)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(IS_LINUX)
+#include <sys/sendfile.h>
+#endif
+
+// Prototypes for local functions
+std::string get_real_path(const std::string& fileName);
+#if defined(IS_LINUX) || defined(IS_MAC)
+bool has_stamp(const struct stat& st, const ftl::FileStamp& stamp);
+#endif
+
+/**
+ * Retrieves the absolute path of a file resolving
+ * symbolic links (the file itself if not found).
+ *
+ * @param fileName the path to the file
+ * @return the resolved path
+ */
+std::string get_real_path(const std::string& fileName) {
+    std::string fullPath = FileUtils::getAbsolutePath(fileName);
+#if defined(IS_LINUX) || defined(IS_MAC)
+    char* realPath = realpath(fullPath.c_str(), nullptr);
+    if (realPath != nullptr) {
+        fullPath = realPath;
+        free(realPath);
+    }
+#endif
+    return fullPath;
+}
+
+#if defined(IS_LINUX) || defined(IS_MAC)
+/**
+ * Checks whether the status of an open file matches
+ * the given stamp (modification time, size and inode).
+ *
+ * @param st the status of the file
+ * @param stamp the stamp
+ * @return true if the file has the stamp, false otherwise
+ */
+bool has_stamp(const struct stat& st, const ftl::FileStamp& stamp) {
+#if defined(IS_MAC)
+    const struct timespec& mtime = st.st_mtimespec;
+#else
+    const struct timespec& mtime = st.st_mtim;
+#endif
+    return (stamp.mtime_ == static_cast<uint64_t>(mtime.tv_sec) * 1000000000ULL + static_cast<uint64_t>(mtime.tv_nsec))
+           && (stamp.size_ == static_cast<uint64_t>(st.st_size)) && (stamp.inode_ == static_cast<uint64_t>(st.st_ino));
+}
+#endif
+
+/**
+ *  Replaces the value of the keys matching the search options
+ *  with the replacement of the options (or the replacement of
+ *  every term in batch mode) in the given files. The modified
+ *  files are prepared in parallel and then replace the originals
+ *  all together, so either all files are modified or none of them is.
+ *  Concurrent edits wait for the journal lock.
+ *
+ *  @param searchOptions the search options
+ *  @param files the list of files to modify
+ *  @param res the output result in case of errors
+ *
+ * @return the matches replaced
+ */
+std::unique_ptr<PropsSearchResult> PropsWriter::processEdit(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files, Result& res) {
+    std::unique_ptr<PropsSearchResult> searchResult;
+    int lock = -1;
+
+    if (lockJournal(true, lock)) {
+        // Finish first any edit interrupted in a previous run
+        recoverJournal();
+        searchResult = editFiles(searchOptions, files, res);
+        unlockJournal(lock);
+    } else {
+        res = res::ERROR;
+        res.setMessage(std::string("Unable to lock the edit journal : ") + strerror(errno) + "\nNo files were modified");
+        searchResult.reset(new PropsSearchResult(searchOptions));
+    }
+
+    return searchResult;
+}
+
+/**
+ * Searches the given files (once per resolved path) and
+ * replaces the values found, all files or none.
+ *
+ *  @param searchOptions the search options
+ *  @param files the list of files to modify
+ *  @param res the output result in case of errors
+ *
+ * @return the matches replaced
+ */
+std::unique_ptr<PropsSearchResult> PropsWriter::editFiles(PropsSearchOptions& searchOptions, const std::list<PropsFile>& files, Result& res) {
+
+    // Files resolving to the same path (links, relative paths...) are edited once,
+    // stamped before being searched to detect later changes
+    std::list<PropsFile> uniqueFiles;
+    std::unordered_set<std::string> fullPaths;
+    std::unordered_map<std::string, writer::FileEdit> fileEdits;
+    std::string error;
+    for (auto& file : files) {
+        std::string fullPath = get_real_path(file.getFileName());
+        if (fullPaths.insert(fullPath).second) {
+            writer::FileEdit fileEdit{};
+            fileEdit.fileName_ = file.getFileName();
+            fileEdit.fullPath_ = fullPath;
+
+            // Every file must be readable before any is searched (all files or none)
+            bool readable = FileUtils::getFileStamp(fullPath, fileEdit.stamp_);
+            if (readable && FileUtils::isDirectory(fullPath)) {
+                errno = EISDIR;
+                readable = false;
+            }
+            readable = readable && std::ifstream(fullPath).is_open();
+            if (!readable) {
+                error += (error.empty() ? "" : "\n") + ("Unable to open file \"" + file.getFileName() + "\" : " + strerror(errno));
+            }
+
+            fileEdits.insert(std::make_pair(file.getFileName(), fileEdit));
+            uniqueFiles.push_back(file);
+        }
+    }
+
+    if (!error.empty()) {
+        res = res::ERROR;
+        res.setMessage(error + "\nNo files were modified");
+        return std::unique_ptr<PropsSearchResult>(new PropsSearchResult(searchOptions));
+    }
+
+    std::unique_ptr<PropsSearchResult> searchResult = PropsReader::processSearch(searchOptions, uniqueFiles);
+
+    // Batch changes are applied to every file in a single pass (in line order)
+    p_search_res::result_view fileKeys = searchResult->getFileKeys();
+    std::vector<std::vector<p_search_res::Match>> batchMatches(searchOptions.isBatch() ? fileKeys.size() : 0);
+    for (size_t i = 0; i < batchMatches.size(); i++) {
+        batchMatches[i].assign(fileKeys[i].matches_.begin(), fileKeys[i].matches_.end());
+        std::stable_sort(batchMatches[i].begin(), batchMatches[i].end(), [](const p_search_res::Match& a, const p_search_res::Match& b) {
+            return a.lineOffset_ < b.lineOffset_;
+        });
+        fileKeys[i].matches_ = p_search_res::MatchRange(batchMatches[i].data(), batchMatches[i].data() + batchMatches[i].size());
+    }
+
+    // Prepare the modified files in parallel
+    const PropsSearchOptions* pOptions = &searchResult->getSearchOptions();
+    std::vector<writer::FileEdit> edits(fileKeys.size());
+    std::vector<std::future<bool>> prepared;
+    auto edit = edits.begin();
+    for (auto& fileKey : fileKeys) {
+        writer::FileEdit* pEdit = &*(edit++);
+        const p_search_res::MatchRange* pMatches = &fileKey.matches_;
+        *pEdit = fileEdits.at(*fileKey.fileName_);
+        prepared.push_back(ThreadPool::getDefault().submit([pEdit, pOptions, pMatches]() {
+            return prepareFile(*pEdit, *pOptions, *pMatches);
+        }));
+    }
+
+    bool ok = true;
+    for (auto& file : prepared) {
+        file.wait();
+    }
+    for (auto& file : prepared) {
+        ok = file.get() && ok;
+    }
+
+    if (ok) {
+        ok = commit(edits, error);
+    } else {
+        for (auto& fileEdit : edits) {
+            if (!fileEdit.error_.empty()) {
+                error += (error.empty() ? "" : "\n") + fileEdit.error_;
+            }
+        }
+        cleanUp(edits);
+    }
+
+    if (!ok) {
+        res = res::ERROR;
+        res.setMessage(error + "\nNo files were modified");
+    }
+
+    return searchResult;
+}
+
+/**
+ * Completes or rolls back an edit interrupted before
+ * finishing, as recorded in the journal (if any). Nothing
+ * is done while another process is editing.
+ */
+void PropsWriter::recover() {
+    int lock = -1;
+    if (lockJournal(false, lock)) {
+        recoverJournal();
+        unlockJournal(lock);
+    }
+}
+
+/**
+ * Completes or rolls back the edit recorded in the
+ * journal (if any). The journal lock must be held.
+ */
+void PropsWriter::recoverJournal() {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    const std::string journalPath = getJournalPath();
+    std::ifstream journal(journalPath, std::ios::binary);
+
+    if (journal.is_open()) {
+        std::istringstream contents(std::string((std::istreambuf_iterator<char>(journal)), std::istreambuf_iterator<char>()));
+        journal.close();
+
+        std::vector<std::string> entries;
+        std::string entry;
+        while (std::getline(contents, entry, '\0')) {
+            entries.push_back(entry);
+        }
+
+        bool committed = (!entries.empty() && (entries.back() == writer::JOURNAL_COMMITTED));
+        std::vector<writer::FileEdit> edits;
+        for (size_t i = 0; i + 2 < entries.size(); i += 3) {
+            edits.push_back(writer::FileEdit{entries[i], entries[i], entries[i + 1], entries[i + 2], "", ftl::FileStamp{}});
+        }
+
+        // Only committed edits may keep the new files
+        if (committed) {
+            cleanUp(edits);
+        } else {
+            rollback(edits);
+        }
+
+        unlink(journalPath.c_str());
+    }
+#endif
+}
+
+/**
+ * Takes the exclusive lock of the journal, held
+ * by the process editing or recovering.
+ *
+ * @param wait true to wait for the lock, false to fail if held
+ * @param lock the descriptor holding the lock
+ * @return true if locked, false otherwise
+ */
+bool PropsWriter::lockJournal(const bool& wait, int& lock) {
+    bool locked = true;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    const std::string journalPath = getJournalPath();
+    std::string lockPath = journalPath.substr(0, journalPath.find_last_of(ftl::pathSeparator) + 1) + writer::JOURNAL_LOCK_NAME;
+    FileUtils::createDirectories(lockPath);
+
+    lock = ::open(lockPath.c_str(), O_RDWR | O_CREAT, 0600);
+    locked = (lock != -1);
+    if (locked) {
+        int rc;
+        while (((rc = flock(lock, LOCK_EX | (wait ? 0 : LOCK_NB))) != 0) && (errno == EINTR)) {
+        }
+        locked = (rc == 0);
+        if (!locked) {
+            int lockError = errno;
+            ::close(lock);
+            lock = -1;
+            errno = lockError;
+        }
+    }
+#endif
+    return locked;
+}
+
+/**
+ * Releases the lock of the journal.
+ *
+ * @param lock the descriptor holding the lock
+ */
+void PropsWriter::unlockJournal(const int& lock) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    if (lock != -1) {
+        ::close(lock);
+    }
+#endif
+}
+
+/**
+ * Writes the modified contents of a file to a temporary file
+ * in the same directory, synced to disk. Only the values are
+ * written, the rest of the file is copied by the kernel when
+ * possible. The file must not have changed since it was searched.
+ *
+ * @param edit the file to modify
+ * @param searchOptions the search options (with the replacements)
+ * @param matches the matches in line order
+ * @return true if the temporary file was written, false otherwise
+ */
+bool PropsWriter::prepareFile(writer::FileEdit& edit, const PropsSearchOptions& searchOptions, const p_search_res::MatchRange& matches) {
+    bool ok = false;
+    const std::string& fileName = edit.fileName_;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    // The target of symbolic links is replaced instead of the link (already resolved)
+    int in = ::open(edit.fullPath_.c_str(), O_RDONLY);
+    struct stat st{};
+    if ((in == -1) || (fstat(in, &st) != 0)) {
+        edit.error_ = "Unable to open file \"" + fileName + "\" : " + strerror(errno);
+        if (in != -1) {
+            ::close(in);
+        }
+        return false;
+    }
+
+    // Make sure the file did not change since it was searched
+    if (!has_stamp(st, edit.stamp_)) {
+        edit.error_ = "File \"" + fileName + "\" changed while editing";
+        ::close(in);
+        return false;
+    }
+
+    std::string tempPath = edit.fullPath_ + writer::TEMP_FILE_SUFFIX;
+    int out = mkstemp(&tempPath[0]);
+    if (out == -1) {
+        edit.error_ = "Unable to create temporary file for \"" + fileName + "\" : " + strerror(errno);
+        ::close(in);
+        return false;
+    }
+    edit.tempPath_ = tempPath;
+
+    ok = true;
+    size_t pos = 0;
+    for (auto it = matches.begin(); ok && (it != matches.end()); ++it) {
+        const p_search_res::Match& match = *it;
+
+        // Only the first change of a line applies
+        if ((it != matches.begin()) && (match.lineOffset_ == std::prev(it)->lineOffset_)) {
+            continue;
+        }
+
+        const std::string& replacement = searchOptions.isBatch() ? searchOptions.getBatchReplacements()[match.termId_] : searchOptions.getReplacement();
+        const char* value = match.value_.data();
+        size_t valueStart = match.lineOffset_ + static_cast<size_t>(value - match.line_.data());
+        auto valueLength = static_cast<size_t>(match.value_.size());
+
+        // Keep the carriage return of CRLF line endings
+        if ((valueLength > 0) && (value + valueLength == match.line_.data() + match.line_.size()) && (value[valueLength - 1] == '\r')) {
+            valueLength--;
+        }
+
+        ok = (valueStart >= pos) && (valueStart + valueLength <= static_cast<size_t>(st.st_size))
+             && copyRange(in, out, pos, valueStart - pos) && writeAll(out, replacement.data(), replacement.size());
+        pos = valueStart + valueLength;
+    }
+
+    ok = ok && copyRange(in, out, pos, static_cast<size_t>(st.st_size) - pos);
+
+    // Keep the owner (when allowed) and permissions of the original file
+    ok = ok && ((fchown(out, st.st_uid, st.st_gid) == 0) || (errno == EPERM))
+            && (fchmod(out, st.st_mode & 07777) == 0) && (fsync(out) == 0);
+    ok = (::close(out) == 0) && ok;
+    ::close(in);
+
+    if (!ok && edit.error_.empty()) {
+        edit.error_ = "Unable to write file \"" + fileName + "\" : " + strerror(errno);
+    }
+#else
+    edit.error_ = "Edition of file \"" + fileName + "\" not supported in this platform";
+#endif
+    return ok;
+}
+
+/**
+ * Replaces the files with their temporary files keeping a backup
+ * (hard link) of the originals until all of them are replaced.
+ * The journal allows to roll back the edit if interrupted. No
+ * file is replaced if any changed since it was searched.
+ *
+ * @param edits the prepared files
+ * @param error the error message in case of failure
+ * @return true if all files were replaced, false if none was
+ */
+bool PropsWriter::commit(std::vector<writer::FileEdit>& edits, std::string& error) {
+    bool ok = true;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    if (edits.empty()) {
+        return ok;
+    }
+
+    for (auto& edit : edits) {
+        edit.backupPath_ = edit.tempPath_ + writer::BACKUP_FILE_SUFFIX;
+    }
+
+    ok = writeJournal(edits, false);
+    if (!ok) {
+        error = "Unable to write the edit journal";
+    }
+
+    for (auto it = edits.begin(); ok && (it != edits.end()); ++it) {
+        ftl::FileStamp stamp{};
+        ok = FileUtils::getFileStamp(it->fullPath_, stamp) && (memcmp(&stamp, &it->stamp_, sizeof(ftl::FileStamp)) == 0);
+        if (!ok) {
+            error = "File \"" + it->fileName_ + "\" changed while editing";
+        }
+    }
+
+    for (auto it = edits.begin(); ok && (it != edits.end()); ++it) {
+        ok = (link(it->fullPath_.c_str(), it->backupPath_.c_str()) == 0);
+        if (!ok) {
+            error = "Unable to backup file \"" + it->fileName_ + "\" : " + strerror(errno);
+        }
+    }
+
+    for (auto it = edits.begin(); ok && (it != edits.end()); ++it) {
+        ok = (::rename(it->tempPath_.c_str(), it->fullPath_.c_str()) == 0);
+        if (!ok) {
+            error = "Unable to replace file \"" + it->fileName_ + "\" : " + strerror(errno);
+        }
+    }
+
+    if (ok) {
+        for (auto& edit : edits) {
+            syncDirectory(edit.fullPath_);
+        }
+        ok = writeJournal(edits, true);
+        if (!ok) {
+            error = "Unable to write the edit journal";
+        }
+    }
+
+    if (ok) {
+        cleanUp(edits);
+    } else {
+        rollback(edits);
+    }
+
+    unlink(getJournalPath().c_str());
+#else
+    ok = edits.empty();
+    error = "Edition not supported in this platform";
+#endif
+    return ok;
+}
+
+/**
+ * Restores the files already replaced from their backups and
+ * removes the temporary files of an edit.
+ *
+ * @param edits the files of the edit
+ */
+void PropsWriter::rollback(const std::vector<writer::FileEdit>& edits) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    for (auto& edit : edits) {
+        if (!edit.backupPath_.empty() && (access(edit.backupPath_.c_str(), F_OK) == 0)) {
+            if (::rename(edit.backupPath_.c_str(), edit.fullPath_.c_str()) == 0) {
+                syncDirectory(edit.fullPath_);
+            }
+        }
+    }
+#endif
+    cleanUp(edits);
+}
+
+/**
+ * Removes the backups and temporary files of an edit.
+ *
+ * @param edits the files of the edit
+ */
+void PropsWriter::cleanUp(const std::vector<writer::FileEdit>& edits) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    for (auto& edit : edits) {
+        if (!edit.tempPath_.empty()) {
+            unlink(edit.tempPath_.c_str());
+        }
+        if (!edit.backupPath_.empty()) {
+            unlink(edit.backupPath_.c_str());
+        }
+    }
+#endif
+}
+
+/**
+ * Writes atomically the journal of an edit, synced to disk.
+ * The journal holds the target, temporary and backup paths
+ * of every file (separated by NUL characters) followed by
+ * the commit mark once all files are replaced.
+ *
+ * @param edits the files of the edit
+ * @param committed true to add the commit mark, false otherwise
+ * @return true if the journal was written, false otherwise
+ */
+bool PropsWriter::writeJournal(const std::vector<writer::FileEdit>& edits, const bool& committed) {
+    bool ok = false;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    const std::string journalPath = getJournalPath();
+    FileUtils::createDirectories(journalPath);
+
+    std::string contents;
+    for (auto& edit : edits) {
+        contents.append(edit.fullPath_).append(1, '\0');
+        contents.append(edit.tempPath_).append(1, '\0');
+        contents.append(edit.backupPath_).append(1, '\0');
+    }
+    if (committed) {
+        contents.append(writer::JOURNAL_COMMITTED).append(1, '\0');
+    }
+
+    std::string tempPath = journalPath + writer::TEMP_FILE_SUFFIX;
+    int fd = mkstemp(&tempPath[0]);
+    if (fd != -1) {
+        ok = writeAll(fd, contents.data(), contents.size()) && (fsync(fd) == 0);
+        ok = (::close(fd) == 0) && ok;
+        ok = ok && (::rename(tempPath.c_str(), journalPath.c_str()) == 0);
+        if (ok) {
+            syncDirectory(journalPath);
+        } else {
+            unlink(tempPath.c_str());
+        }
+    }
+#endif
+    return ok;
+}
+
+/**
+ * Retrieves the path of the edit journal.
+ *
+ * @return the path of the journal
+ */
+std::string PropsWriter::getJournalPath() {
+    return config::CONFIG_FULL_PATH() + writer::JOURNAL_FOLDER + ftl::pathSeparator + writer::JOURNAL_FILE_NAME;
+}
+
+/**
+ * Persists the entries of the directory of a file.
+ *
+ * @param path the path of the file
+ */
+void PropsWriter::syncDirectory(const std::string& path) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    std::string directory = path.substr(0, path.find_last_of(ftl::pathSeparator) + 1);
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd != -1) {
+        fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
+
+/**
+ * Copies a range of the source file at the current position of
+ * the target file. The copy is performed in kernel space (avoiding
+ * user space buffers) unless not supported by the file system.
+ * Interrupted calls are retried.
+ *
+ * @param in the source file descriptor
+ * @param out the target file descriptor
+ * @param offset the start of the range
+ * @param length the length of the range
+ * @return true if the range was copied, false otherwise
+ */
+bool PropsWriter::copyRange(const int& in, const int& out, size_t offset, size_t length) {
+    bool ok = true;
+#if defined(IS_LINUX) || defined(IS_MAC)
+#if defined(IS_LINUX)
+    ssize_t copied = 1;
+    while (((copied > 0) || ((copied < 0) && (errno == EINTR))) && (length > 0)) {
+        loff_t inOffset = static_cast<loff_t>(offset);
+        copied = copy_file_range(in, &inOffset, out, nullptr, length, 0);
+        if (copied > 0) {
+            offset += copied;
+            length -= copied;
+        }
+    }
+
+    copied = 1;
+    while (((copied > 0) || ((copied < 0) && (errno == EINTR))) && (length > 0)) {
+        auto inOffset = static_cast<off_t>(offset);
+        copied = sendfile(out, in, &inOffset, length);
+        if (copied > 0) {
+            offset += copied;
+            length -= copied;
+        }
+    }
+#endif
+
+    // Fallback to a buffered copy
+    std::vector<char> buffer((length < writer::COPY_BUFFER_SIZE) ? length : writer::COPY_BUFFER_SIZE);
+    while (ok && (length > 0)) {
+        ssize_t read = pread(in, buffer.data(), buffer.size() < length ? buffer.size() : length, static_cast<off_t>(offset));
+        ok = ((read > 0) && writeAll(out, buffer.data(), static_cast<size_t>(read))) || ((read < 0) && (errno == EINTR));
+        if (ok && (read > 0)) {
+            offset += read;
+            length -= read;
+        }
+    }
+#else
+    ok = (length == 0);
+#endif
+    return ok;
+}
+
+/**
+ * Writes the whole buffer at the current position of the file
+ * (retrying interrupted writes).
+ *
+ * @param out the target file descriptor
+ * @param data the buffer to write
+ * @param length the length of the buffer
+ * @return true if the buffer was written, false otherwise
+ */
+bool PropsWriter::writeAll(const int& out, const char* data, size_t length) {
+    bool ok = true;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    while (ok && (length > 0)) {
+        ssize_t written = ::write(out, data, length);
+        ok = (written > 0) || ((written < 0) && (errno == EINTR));
+        if (written > 0) {
+            data += written;
+            length -= written;
+        }
+    }
+#else
+    ok = (length == 0);
+#endif
+    return ok;
+}
@@ -15,6 +15,7 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <string_utils.h>
 #include <result.h>
 #include "arg_parser.h"
@@ -97,8 +98,11 @@ void ArgParser::readOptions(const PropsArg& arg, ArgStore& argStore, Result& res
             argStore.addArg(std::string(argStore.getArgv()[index]));
         }
 
-        // Check at least same attached args than non options
-        if (arg.getAttachedArgs().size() > argStore.getArgs().size()) {
+        // Check at least same mandatory attached args than non options (optional ones are enclosed in brackets)
+        auto mandatoryArgs = std::count_if(arg.getAttachedArgs().begin(), arg.getAttachedArgs().end(), [](const std::string& attachedArg) {
+            return attachedArg.empty() || (attachedArg[0] != '[');
+        });
+        if (static_cast<size_t>(mandatoryArgs) > argStore.getArgs().size()) {
             result = res::ERROR;
             result.setMessage("Missing arguments");
         }
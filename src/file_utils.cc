@@ -16,10 +16,17 @@
 
 #include "file_utils.h"
 #include "config_static.h"
+#include "string_utils.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
 
 #if defined(IS_LINUX) || defined(IS_MAC)
 #include <unistd.h>
 #include <pwd.h>
+#include <fnmatch.h>
+#include <glob.h>
+#include <sys/stat.h>
 #endif
 
 #if defined(__cplusplus) && __cplusplus >= 201703L && defined(__has_include)
@@ -54,6 +61,117 @@ bool FileUtils::createDirectories(const std::string& directory) noexcept {
     return result;
 }
 
+/**
+ * Checks if a given path is a directory.
+ *
+ * @param path the path to check
+ * @return true if the path is a directory, false otherwise
+ */
+bool FileUtils::isDirectory(const std::string& path) noexcept {
+    std::error_code ec;
+    return fs::is_directory(path, ec);
+}
+
+/**
+ * Retrieves the files of a directory whose name matches the
+ * given glob pattern and its subdirectories (symbolic links
+ * to directories are not followed). The paths found are
+ * lexically normalized (i.e. without "." or ".." components).
+ *
+ * @param directory the directory to list
+ * @param pattern the glob pattern for the file names
+ * @param files the matching files found
+ * @param directories the subdirectories found
+ * @return true if the directory could be read, false otherwise
+ */
+bool FileUtils::listDirectory(const std::string& directory, const std::string& pattern,
+                              std::vector<std::string>& files, std::vector<std::string>& directories) noexcept {
+    std::error_code ec;
+    fs::directory_iterator it(directory, ec);
+    bool result = !ec;
+
+    for (fs::directory_iterator end; !ec && (it != end); it.increment(ec)) {
+        std::error_code statusEc;
+        if (fs::is_directory(it->symlink_status(statusEc))) {
+            directories.push_back(it->path().lexically_normal().string());
+        } else if (fs::is_regular_file(it->status(statusEc))) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+            if (fnmatch(pattern.c_str(), it->path().filename().string().c_str(), 0) == 0) {
+                files.push_back(it->path().lexically_normal().string());
+            }
+#else
+            files.push_back(it->path().lexically_normal().string());
+#endif
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Retrieves the (lexically normalized) paths matching
+ * a given glob pattern.
+ *
+ * @param pattern the glob pattern
+ * @param paths the matching paths found
+ * @return true if any path matched, false otherwise
+ */
+bool FileUtils::expandPattern(const std::string& pattern, std::vector<std::string>& paths) noexcept {
+    bool result = false;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    glob_t globResult{};
+    if (glob(pattern.c_str(), 0, nullptr, &globResult) == 0) {
+        for (size_t i = 0; i < globResult.gl_pathc; i++) {
+            paths.push_back(fs::path(globResult.gl_pathv[i]).lexically_normal().string());
+        }
+        result = (globResult.gl_pathc > 0);
+    }
+    globfree(&globResult);
+#endif
+    return result;
+}
+
+/**
+ * Reads the entries of a batch from a comma separated list,
+ * a file (@file) or the standard input (-). Entries are trimmed
+ * and blank ones and comments (starting with #) are skipped.
+ *
+ * @param source the entries source
+ * @param entries the entries read
+ * @return true if the source could be read, false otherwise
+ */
+bool FileUtils::readBatchEntries(const std::string& source, std::vector<std::string>& entries) {
+    bool result = true;
+    std::vector<std::string> lines;
+    std::string line;
+
+    if (source == ftl::batchStdin) {
+        while (std::getline(std::cin, line)) {
+            lines.push_back(line);
+        }
+    } else if (!source.empty() && (source[0] == ftl::batchFile)) {
+        std::ifstream infile(source.substr(1));
+        result = infile.is_open();
+        while (result && std::getline(infile, line)) {
+            lines.push_back(line);
+        }
+    } else {
+        std::istringstream list(source);
+        while (std::getline(list, line, ftl::batchList)) {
+            lines.push_back(line);
+        }
+    }
+
+    for (auto& entry : lines) {
+        StringUtils::trim(entry);
+        if (!entry.empty() && (entry[0] != '#')) {
+            entries.push_back(entry);
+        }
+    }
+
+    return result;
+}
+
 /**
  * Checks if a given file exists and is accessible.
  *
@@ -65,13 +183,53 @@ bool FileUtils::fileExists(const std::string& fileName) noexcept {
 }
 
 /**
- * Retrieves the absolute path of a given file.
+ * Retrieves the size in bytes of a given file.
+ *
+ * @param fileName the path to the file
+ * @return the size of the file or 0 if not accessible
+ */
+size_t FileUtils::getFileSize(const std::string& fileName) noexcept {
+    std::error_code ec;
+    auto size = fs::file_size(fileName, ec);
+    return (ec) ? 0 : static_cast<size_t>(size);
+}
+
+/**
+ * Retrieves the modification time (in nanoseconds), size
+ * and inode of a given file.
+ *
+ * @param fileName the path to the file
+ * @param stamp the file stamp
+ * @return true if the stamp could be retrieved, false otherwise
+ */
+bool FileUtils::getFileStamp(const std::string& fileName, ftl::FileStamp& stamp) noexcept {
+    bool result = false;
+#if defined(IS_LINUX) || defined(IS_MAC)
+    struct stat st{};
+    if (stat(fileName.c_str(), &st) == 0) {
+#if defined(IS_MAC)
+        const struct timespec& mtime = st.st_mtimespec;
+#else
+        const struct timespec& mtime = st.st_mtim;
+#endif
+        stamp.mtime_ = static_cast<uint64_t>(mtime.tv_sec) * 1000000000ULL + static_cast<uint64_t>(mtime.tv_nsec);
+        stamp.size_  = static_cast<uint64_t>(st.st_size);
+        stamp.inode_ = static_cast<uint64_t>(st.st_ino);
+        result = true;
+    }
+#endif
+    return result;
+}
+
+/**
+ * Retrieves the absolute path of a given file
+ * (lexically normalized, symbolic links are kept).
  *
  * @param filePath the path to the file
  * @return retrieves the absolute file path
  */
 std::string	FileUtils::getAbsolutePath(const std::string& filePath) noexcept {
-    return fs::absolute(filePath);
+    return fs::absolute(filePath).lexically_normal();
 }
 
 /**
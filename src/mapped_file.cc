@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mapped_file.h"
+#include "config_static.h"
+
+#if defined(IS_LINUX) || defined(IS_MAC)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+/**
+ * Maps the given file in memory.
+ *
+ * @param fileName the path to the file to map
+ */
+MappedFile::MappedFile(const std::string& fileName) {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd != -1) {
+        struct stat st{};
+        if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode)) {
+            open_ = true;
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ > 0) {
+                void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    // Lines are scanned front to back
+                    madvise(addr, size_, MADV_SEQUENTIAL);
+                    data_ = static_cast<const char*>(addr);
+                    mapped_ = true;
+                } else {
+                    open_ = false;
+                    size_ = 0;
+                }
+            }
+        }
+        // The mapping remains valid once the descriptor is closed
+        ::close(fd);
+    }
+#else
+    std::ifstream infile(fileName, std::ios::binary);
+    if (infile) {
+        buffer_.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        open_ = true;
+    }
+#endif
+}
+
+/**
+ * Releases the mapping (if any).
+ */
+MappedFile::~MappedFile() {
+#if defined(IS_LINUX) || defined(IS_MAC)
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
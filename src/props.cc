@@ -16,6 +16,7 @@
 
 #include <iostream>
 #include <props_config.h>
+#include <props_writer.h>
 #include "props_cmd.h"
 #include "props_cli.h"
 #include "exec_exception.h"
@@ -38,6 +39,9 @@ int main(int argc, char **argv)
     try {
         PropsConfig::getDefault().init();
 
+        // Finish any edit interrupted in a previous run
+        PropsWriter::recover();
+
         command = PropsCLI::parse(argc,argv);
         if (command != nullptr) {
             auto res = command->run();
@@ -18,7 +18,10 @@
 #include <props_tracker_factory.h>
 #include <exec_exception.h>
 #include <sstream>
-#include <props_reader.h>
+#include <unordered_map>
+#include <props_writer.h>
+#include <string_utils.h>
+#include <file_utils.h>
 
 void PropsEditCommand::parse(const int& argc, char* argv[]) {
 
@@ -44,8 +47,13 @@ void PropsEditCommand::parse(const int& argc, char* argv[]) {
         searchOptions++;
     }
 
+    // Check the value is supplied unless in batch mode
+    if (optionStore_.getArgs().size() < getNumEditArgs()) {
+        throw ExecutionException("Missing arguments");
+    }
+
     // Check that only files or search options are supplied
-    if (optionStore_.getArgs().size() > 2 && searchOptions > 0) {
+    if (optionStore_.getArgs().size() > getNumEditArgs() && searchOptions > 0) {
         throw ExecutionException("Only one search option allowed [Files or Tracker]");
     }
 
@@ -80,15 +88,16 @@ std::unique_ptr<PropsResult> PropsEditCommand::execute() {
 }
 
 /**
- * Perform a search using the supplied options.
+ * Modifies the values of the matching keys using the supplied options.
  *
  * @return the modification results
  */
 std::unique_ptr<PropsResult> PropsEditCommand::modify() {
     Result res{res::VALID};
+    const bool& isBatch = (optionStore_.getOptions().count(edit_cmd::_BATCH_EDIT_) != 0);
     auto it = std::begin(optionStore_.getArgs());
     const std::string& term  = *it;
-    const std::string& value = *++it;
+    const std::string& value = isBatch ? "" : *++it;
     std::unique_ptr<PropsSearchResult> searchResult(nullptr);
 
     // Retrieve search options
@@ -114,6 +123,14 @@ std::unique_ptr<PropsResult> PropsEditCommand::modify() {
     searchOptions.setReplacement(value);
     searchOptions.setReplace(true);
 
+    if (isBatch) {
+        std::vector<std::string> batchKeys;
+        std::vector<std::string> batchValues;
+        retrieveBatchChanges(term, batchKeys, batchValues);
+        searchOptions.setBatchKeys(batchKeys);
+        searchOptions.setBatchReplacements(batchValues);
+    }
+
     if (fileList.empty()) {
         res = res::ERROR;
         res.setSeverity(res::WARN);
@@ -121,7 +138,7 @@ std::unique_ptr<PropsResult> PropsEditCommand::modify() {
         searchResult.reset(new PropsSearchResult(searchOptions));
         searchResult->setResult(res);
     } else {
-        searchResult = PropsReader::processSearch(searchOptions, fileList);
+        searchResult = PropsWriter::processEdit(searchOptions, fileList, res);
         searchResult->setResult(res);
     }
 
@@ -136,10 +153,10 @@ std::unique_ptr<PropsResult> PropsEditCommand::modify() {
  */
 void PropsEditCommand::retrieveFileList(std::list<PropsFile>& fileList, Result& res) {
     // Check if files supplied manually
-    if (optionStore_.getArgs().size() > 2) {
-        // Skip key and value arguments and consider the rest as files
+    if (optionStore_.getArgs().size() > getNumEditArgs()) {
+        // Skip key and value (or changes) arguments and consider the rest as files
         auto it = std::begin(optionStore_.getArgs());
-        std::advance(it, 2);
+        std::advance(it, getNumEditArgs());
         for (auto end = std::end(optionStore_.getArgs()); it != end; ++it) {
             fileList.push_back(PropsFile::make_file(*it));
         }
@@ -159,12 +176,7 @@ void PropsEditCommand::retrieveFileList(std::list<PropsFile>& fileList, Result&
             fileList = propsTracker_->getTrackedFiles();
         } else if (option_map.count(edit_cmd::_GROUP_SEARCH_) != 0) {
             auto& group = option_map.at(edit_cmd::_GROUP_SEARCH_);
-            const std::list<PropsFile *> *pGroupList = propsTracker_->getGroup(group);
-            if (pGroupList != nullptr) {
-                for (auto pFile : *pGroupList) {
-                    fileList.push_back(*pFile);
-                }
-            } else {
+            if (!propsTracker_->getGroup(group, fileList)) {
                 res = res::ERROR;
                 res.setMessage("Group \"" + group + "\" not found");
             }
@@ -175,5 +187,60 @@ void PropsEditCommand::retrieveFileList(std::list<PropsFile>& fileList, Result&
                 fileList.push_back(*masterFile);
             }
         }
+
+        // Skip the tracked files that cannot be read
+        propsTracker_->validate(fileList);
+    }
+}
+
+/**
+ * Retrieves the number of arguments preceding the
+ * list of files (the key and value or the changes).
+ *
+ * @return the number of arguments before the files
+ */
+size_t PropsEditCommand::getNumEditArgs() const {
+    return (optionStore_.getOptions().count(edit_cmd::_BATCH_EDIT_) != 0) ? 1 : 2;
+}
+
+/**
+ * Retrieves the changes of a batch edit from a comma separated list,
+ * a file (@file) or the standard input (-). Blank lines and comments
+ * are skipped and the last change of a repeated key prevails.
+ *
+ * @param source the changes source
+ * @param keys the keys to modify
+ * @param values the new values of the keys
+ */
+void PropsEditCommand::retrieveBatchChanges(const std::string& source, std::vector<std::string>& keys, std::vector<std::string>& values) {
+    std::vector<std::string> entries;
+    std::unordered_map<std::string, size_t> keyIndexes;
+
+    if (!FileUtils::readBatchEntries(source, entries)) {
+        throw ExecutionException("Cannot read changes from \"" + source.substr(1) + "\"");
+    }
+
+    for (auto& change : entries) {
+        auto pos = change.find(edit_cmd::BATCH_CHANGE_);
+        std::string key = change.substr(0, pos);
+        StringUtils::trim(key);
+        if ((pos == std::string::npos) || key.empty()) {
+            throw ExecutionException("Invalid change \"" + change + "\" (expected key=value)");
+        }
+
+        std::string value = change.substr(pos + 1);
+        StringUtils::trim(value);
+
+        auto keyIndex = keyIndexes.insert(std::make_pair(key, keys.size()));
+        if (keyIndex.second) {
+            keys.push_back(key);
+            values.push_back(value);
+        } else {
+            values[keyIndex.first->second] = value;
+        }
     }
-}
\ No newline at end of file
+
+    if (keys.empty()) {
+        throw ExecutionException("No changes supplied for batch edit");
+    }
+}
@@ -18,7 +18,11 @@
 #include <props_tracker_factory.h>
 #include <exec_exception.h>
 #include <sstream>
+#include <unordered_set>
 #include <props_reader.h>
+#include <props_formatter_factory.h>
+#include <string_utils.h>
+#include <file_utils.h>
 
 void PropsSearchCommand::parse(const int& argc, char* argv[]) {
 
@@ -52,6 +56,14 @@ void PropsSearchCommand::parse(const int& argc, char* argv[]) {
     if (searchOptions > 1) {
         throw ExecutionException("Only one search option allowed [Alias, Group, Multi]");
     }
+
+    // Check the output format
+    if (optionStore_.getOptions().count(search_cmd::_OUTPUT_FORMAT_) != 0) {
+        if (optionStore_.getOptions().count(search_cmd::_USE_JSON_) != 0) {
+            throw ExecutionException("Only one output option allowed [Json, Format]");
+        }
+        retrieveFormatterName();
+    }
 }
 
 /**
@@ -111,6 +123,12 @@ std::unique_ptr<PropsResult> PropsSearchCommand::search() {
     searchOptions.setIsRegex(isRegex);
     searchOptions.setReplace(false);
 
+    if (optionStore_.getOptions().count(search_cmd::_BATCH_SEARCH_) != 0) {
+        std::vector<std::string> batchKeys;
+        retrieveBatchKeys(term, batchKeys);
+        searchOptions.setBatchKeys(batchKeys);
+    }
+
     if (fileList.empty()) {
         res = res::ERROR;
         res.setSeverity(res::WARN);
@@ -118,14 +136,55 @@ std::unique_ptr<PropsResult> PropsSearchCommand::search() {
         searchResult.reset(new PropsSearchResult(searchOptions));
         searchResult->setResult(res);
     } else {
-        searchResult = PropsReader::processSearch(searchOptions, fileList);
+        std::string formatterName = retrieveFormatterName();
+
+        // Show the results of every file as soon as searched (batch results are grouped by term)
+        std::unique_ptr<PropsResultSink> sink;
+        if (!searchOptions.isBatch()) {
+            auto formatter = formatterName.empty() ? PropsFormatterFactory::getDefaultFormatter() : PropsFormatterFactory::getFormatter(formatterName);
+            sink = formatter->createSink(searchOptions, std::cout);
+        }
+
+        searchResult = PropsReader::processSearch(searchOptions, fileList, sink.get());
         searchResult->setResult(res);
-        searchResult->setEnableJson((optionStore_.getOptions().count(search_cmd::_USE_JSON_) != 0));
+        searchResult->setFormatterName(formatterName);
+
+        if (sink != nullptr) {
+            sink->finish();
+        }
     }
 
     return searchResult;
 }
 
+/**
+ * Retrieves the name of the formatter for the
+ * output format supplied (if any).
+ *
+ * @return the formatter name (empty for the default one)
+ */
+std::string PropsSearchCommand::retrieveFormatterName() const {
+    std::string formatterName;
+    const auto& option_map = optionStore_.getOptions();
+
+    if (option_map.count(search_cmd::_USE_JSON_) != 0) {
+        formatterName = formatter::JSON_FORMATTER;
+    } else if (option_map.count(search_cmd::_OUTPUT_FORMAT_) != 0) {
+        const std::string& format = option_map.at(search_cmd::_OUTPUT_FORMAT_);
+        if (format == search_cmd::_FORMAT_JSON_) {
+            formatterName = formatter::JSON_FORMATTER;
+        } else if (format == search_cmd::_FORMAT_NDJSON_) {
+            formatterName = formatter::NDJSON_FORMATTER;
+        } else if (format == search_cmd::_FORMAT_MSGPACK_) {
+            formatterName = formatter::MSGPACK_FORMATTER;
+        } else if (format != search_cmd::_FORMAT_TEXT_) {
+            throw ExecutionException("Unknown output format \"" + format + "\" [text, json, ndjson, msgpack]");
+        }
+    }
+
+    return formatterName;
+}
+
 /**
  * Retrieves the list of files to lookup from the given options.
  *
@@ -157,12 +216,7 @@ void PropsSearchCommand::retrieveFileList(std::list<PropsFile>& fileList, Result
             fileList = propsTracker_->getTrackedFiles();
         } else if (option_map.count(search_cmd::_GROUP_SEARCH_) != 0) {
             auto& group = option_map.at(search_cmd::_GROUP_SEARCH_);
-            const std::list<PropsFile *> *pGroupList = propsTracker_->getGroup(group);
-            if (pGroupList != nullptr) {
-                for (auto pFile : *pGroupList) {
-                    fileList.push_back(*pFile);
-                }
-            } else {
+            if (!propsTracker_->getGroup(group, fileList)) {
                 res = res::ERROR;
                 res.setMessage("Group \"" + group + "\" not found");
             }
@@ -173,5 +227,35 @@ void PropsSearchCommand::retrieveFileList(std::list<PropsFile>& fileList, Result
                 fileList.push_back(*masterFile);
             }
         }
+
+        // Skip the tracked files that cannot be read
+        propsTracker_->validate(fileList);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Retrieves the terms of a batch search from a comma separated list,
+ * a file (@file) or the standard input (-). Blank lines and comments
+ * are skipped and duplicated terms are removed.
+ *
+ * @param source the terms source
+ * @param keys the list of terms
+ */
+void PropsSearchCommand::retrieveBatchKeys(const std::string& source, std::vector<std::string>& keys) {
+    std::vector<std::string> entries;
+    std::unordered_set<std::string> uniqueKeys;
+
+    if (!FileUtils::readBatchEntries(source, entries)) {
+        throw ExecutionException("Cannot read terms from \"" + source.substr(1) + "\"");
+    }
+
+    for (auto& key : entries) {
+        if (uniqueKeys.insert(key).second) {
+            keys.push_back(key);
+        }
+    }
+
+    if (keys.empty()) {
+        throw ExecutionException("No terms supplied for batch search");
+    }
+}
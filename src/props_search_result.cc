@@ -17,38 +17,225 @@
 #include <props_formatter_factory.h>
 #include "props_search_result.h"
 #include "string_utils.h"
+#include <algorithm>
 
 
 /**
- * Appends the pair key/value found in the given file
- * to the results map.
+ * Appends the matches found in the given file (in line
+ * order) to the results, grouping them by the matched
+ * term for batch searches. The matches of a file are
+ * kept contiguous in the arena.
  *
- * @param file the file where the key was found
- * @param key the searched key
- * @param value the value found
+ * @param file the file where the matches were found
+ * @param ranges the matches found in every range of the file
  */
-void PropsSearchResult::add(const std::string &file, const p_search_res::Match &match) {
-    this->fileKeys_[file].push_back(match);
+void PropsSearchResult::add(const std::string &file, const std::vector<const std::vector<p_search_res::Match>*>& ranges) {
+    size_t numMatches = 0;
+    for (auto* range : ranges) {
+        numMatches += range->size();
+    }
+
+    if (numMatches == 0) {
+        return;
+    }
+
+    // Intern the file name
+    auto it = fileIds_.find(file);
+    if (it == fileIds_.end()) {
+        it = fileIds_.emplace(file, fileNames_.size()).first;
+        fileNames_.push_back(file);
+        fileMatches_.emplace_back();
+    }
+    p_search_res::MatchRange& current = fileMatches_[it->second];
+
+    // Files searched more than once are appended to the previous matches
+    p_search_res::Match* matches = matches_.allocate(current.size() + numMatches);
+    p_search_res::Match* last = std::copy(current.begin(), current.end(), matches);
+    for (auto* range : ranges) {
+        last = std::copy(range->begin(), range->end(), last);
+    }
+
+    if (searchOptions_.isBatch()) {
+        std::stable_sort(matches, last, [](const p_search_res::Match& a, const p_search_res::Match& b) {
+            return a.termId_ < b.termId_;
+        });
+    }
+
+    current = p_search_res::MatchRange(matches, last);
 }
 
 /**
- * Retrieves the results for the given file.
+ * Retrieves the results for the given files
+ * sorted by file name.
  *
- * @param fileName the file names to retrieve results
- * @param key the searched key
- * @param list the results for the given key
+ * @param fileNames the list of file names to retrieve results from
+ * @return the results for the given files
  */
-p_search_res::result_map PropsSearchResult::get(const std::list<std::string> &fileNames) const {
-    p_search_res::result_map results;
+p_search_res::result_view PropsSearchResult::get(const std::list<std::string> &fileNames) const {
+    std::vector<size_t> fileIds;
     for (auto &fileName : fileNames) {
-        if (this->fileKeys_.find(fileName) != this->fileKeys_.end()) {
-            results[fileName] = this->fileKeys_.at(fileName);
+        auto it = fileIds_.find(fileName);
+        if (it != fileIds_.end()) {
+            fileIds.push_back(it->second);
+        }
+    }
+
+    std::sort(fileIds.begin(), fileIds.end(), [this](const size_t& a, const size_t& b) {
+        return fileNames_[a] < fileNames_[b];
+    });
+    fileIds.erase(std::unique(fileIds.begin(), fileIds.end()), fileIds.end());
+
+    p_search_res::result_view results;
+    for (auto &fileId : fileIds) {
+        results.push_back(p_search_res::FileResult{&fileNames_[fileId], fileMatches_[fileId]});
+    }
+
+    return results;
+}
+
+/**
+ * Retrieves all results sorted by file name.
+ *
+ * @return the results for all files
+ */
+p_search_res::result_view PropsSearchResult::getFileKeys() const {
+    std::vector<size_t> fileIds;
+    getSortedFiles(fileIds);
+
+    p_search_res::result_view results;
+    for (auto &fileId : fileIds) {
+        results.push_back(p_search_res::FileResult{&fileNames_[fileId], fileMatches_[fileId]});
+    }
+
+    return results;
+}
+
+/**
+ * Retrieves the results of a batch search term
+ * sorted by file name.
+ *
+ * @param termId the index of the batch term
+ * @return the results of the term for all files
+ */
+p_search_res::result_view PropsSearchResult::getTermResults(const size_t& termId) const {
+    std::vector<size_t> fileIds;
+    getSortedFiles(fileIds);
+
+    p_search_res::result_view results;
+    for (auto &fileId : fileIds) {
+        const p_search_res::MatchRange& matches = fileMatches_[fileId];
+        auto range = std::equal_range(matches.begin(), matches.end(), p_search_res::Match{termId, 0, {}, {}, {}},
+                                      [](const p_search_res::Match& a, const p_search_res::Match& b) {
+            return a.termId_ < b.termId_;
+        });
+        if (range.first != range.second) {
+            results.push_back(p_search_res::FileResult{&fileNames_[fileId], p_search_res::MatchRange(range.first, range.second)});
         }
     }
 
     return results;
 }
 
+/**
+ * Retrieves the identifiers of the files with matches
+ * sorted by file name.
+ *
+ * @param fileIds the sorted file identifiers
+ */
+void PropsSearchResult::getSortedFiles(std::vector<size_t>& fileIds) const {
+    fileIds.resize(fileNames_.size());
+    for (size_t i = 0; i < fileIds.size(); i++) {
+        fileIds[i] = i;
+    }
+
+    std::sort(fileIds.begin(), fileIds.end(), [this](const size_t& a, const size_t& b) {
+        return fileNames_[a] < fileNames_[b];
+    });
+}
+
+/**
+ * Retrieves the property in the line of the given match.
+ * Matches only hold the whole value for key searches and
+ * the whole key for value searches (the other part is
+ * the matched term).
+ *
+ * @param match the match
+ * @param separatorSize the size of the key/value separator
+ * @param matchValue the flag set for value searches
+ * @return the property
+ */
+p_search_res::Property p_search_res::getProperty(const p_search_res::Match& match, const size_t& separatorSize, const bool& matchValue) {
+    const char* lineStart = match.line_.data();
+    const char* lineEnd = lineStart + match.line_.size();
+    const char* keyEnd = (matchValue) ? match.key_.data() + match.key_.size() : match.value_.data() - separatorSize;
+    const char* valueStart = keyEnd + separatorSize;
+
+    return p_search_res::Property{pcrecpp::StringPiece(lineStart, static_cast<int>(keyEnd - lineStart)),
+                                  match.lineOffset_,
+                                  pcrecpp::StringPiece(valueStart, static_cast<int>(lineEnd - valueStart)),
+                                  match.lineOffset_ + static_cast<size_t>(valueStart - lineStart)};
+}
+
+/**
+ * Retrieves the line number of the given match.
+ *
+ * @param match the match
+ * @return the line number (starting at 1)
+ */
+size_t p_search_res::LineCounter::getLineNumber(const p_search_res::Match& match) {
+    const char* data = match.line_.data() - match.lineOffset_;
+    if (match.lineOffset_ < offset_) {
+        lineNumber_ = 1;
+        offset_ = 0;
+    }
+
+    lineNumber_ += static_cast<size_t>(std::count(data + offset_, data + match.lineOffset_, '\n'));
+    offset_ = match.lineOffset_;
+    return lineNumber_;
+}
+
+/**
+ * Computes the line numbers of the matches of the given files.
+ *
+ * @param files the matches of every file
+ */
+p_search_res::LineNumbers::LineNumbers(const p_search_res::result_view& files) {
+    std::vector<size_t> order;
+
+    for (auto &fileResult : files) {
+        const p_search_res::Match* matches = fileResult.matches_.begin();
+        auto& lineNumbers = files_[fileResult.fileName_];
+        lineNumbers.first = matches;
+        lineNumbers.second.resize(fileResult.matches_.size());
+
+        // Count the lines of the file only once walking the matches in line order
+        order.resize(fileResult.matches_.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [matches](const size_t& a, const size_t& b) {
+            return matches[a].lineOffset_ < matches[b].lineOffset_;
+        });
+
+        p_search_res::LineCounter lineCounter;
+        for (auto &i : order) {
+            lineNumbers.second[i] = lineCounter.getLineNumber(matches[i]);
+        }
+    }
+}
+
+/**
+ * Retrieves the line numbers of the matches of
+ * the given file (or part of its matches).
+ *
+ * @param fileResult the matches of a file
+ * @return the line numbers (in the order of the matches)
+ */
+const size_t* p_search_res::LineNumbers::get(const p_search_res::FileResult& fileResult) const {
+    const auto& lineNumbers = files_.at(fileResult.fileName_);
+    return lineNumbers.second.data() + (fileResult.matches_.begin() - lineNumbers.first);
+}
+
 /**
  * Formats the contents of the result in an
  * output stream.
@@ -57,7 +244,7 @@ p_search_res::result_map PropsSearchResult::get(const std::list<std::string> &fi
  */
 void PropsSearchResult::format(std::ostream& out) const {
     out << output_;
-    auto formatter = isEnableJson() ? PropsFormatterFactory::getFormatter(formatter::JSON_FORMATTER) : PropsFormatterFactory::getDefaultFormatter();
+    auto formatter = formatterName_.empty() ? PropsFormatterFactory::getDefaultFormatter() : PropsFormatterFactory::getFormatter(formatterName_);
     if (formatter != nullptr) {
         formatter->format(this, out);
     }
@@ -18,6 +18,8 @@
 #include "props_tracker_cmd.h"
 #include "props_tracker_factory.h"
 #include "exec_exception.h"
+#include "thread_pool.h"
+#include <algorithm>
 #include <sstream>
 
 void PropsTrackerCommand::parse(const int& argc, char* argv[]) {
@@ -61,7 +63,15 @@ std::unique_ptr<PropsResult> PropsTrackerCommand::execute() {
     Result res{res::VALID};
 
     if (optionStore_.getCmdName() == tracker_cmd::_TRACKER_ADD_CMD_) {
-        res = (optionStore_.getArgs().size()>1) ? trackFiles() : trackFile();
+        const std::string& file = optionStore_.getArgs().front();
+        bool isPattern = (file.find_first_of("*?[") != std::string::npos) && !FileUtils::fileExists(file);
+        bool isRecursive = (optionStore_.getOptions().count(tracker_cmd::_RECURSIVE_) != 0);
+        if (!isRecursive && (optionStore_.getOptions().count(tracker_cmd::_FILE_PATTERN_) != 0)) {
+            res = Result{res::ERROR};
+            res.setMessage("The file pattern requires the recursive option");
+        } else {
+            res = ((optionStore_.getArgs().size()>1) || isPattern || isRecursive) ? trackFiles() : trackFile();
+        }
     } else if (optionStore_.getCmdName() == tracker_cmd::_TRACKER_LS_CMD_) {
         propsTracker_->listTracked();
     } else if (optionStore_.getCmdName() == tracker_cmd::_TRACKER_UNALIAS_CMD_) {
@@ -80,6 +90,8 @@ std::unique_ptr<PropsResult> PropsTrackerCommand::execute() {
         res = renameGroup();
     } else if (optionStore_.getCmdName() == tracker_cmd::_TRACKER_CLEAR_CMD_) {
         res = propsTracker_->clear();
+    } else if (optionStore_.getCmdName() == tracker_cmd::_TRACKER_VERIFY_CMD_) {
+        res = propsTracker_->verify(optionStore_.getOptions().count(tracker_cmd::_TRACKER_UNTRACK_CMD_) != 0);
     }
 
     res.showMessage(out);
@@ -112,10 +124,15 @@ Result PropsTrackerCommand::trackFile() {
         propsFile.setGroup(option_map.at(tracker_cmd::_GROUP_NAME_));
     }
 
-    // Adds the file to the tracker
-    Result res = propsTracker_->add(propsFile);
-    if (res.isValid()) {
-        res.setMessage("Now tracking \"" + propsFile.getFileName() + "\"");
+    // Adds the file to the tracker (directories require the recursive option)
+    Result res{res::ERROR};
+    if (FileUtils::isDirectory(propsFile.getFileName())) {
+        res.setMessage("\"" + propsFile.getFileName() + "\" is a directory (use the recursive option to track its files)");
+    } else {
+        res = propsTracker_->add(propsFile);
+        if (res.isValid()) {
+            res.setMessage("Now tracking \"" + propsFile.getFileName() + "\"");
+        }
     }
 
     return res;
@@ -135,23 +152,122 @@ Result PropsTrackerCommand::trackFiles() {
         throw InitializationException("Cannot set alias/master option when adding multiple files to the tracker");
     }
 
+    std::vector<std::string> files;
+    Result res = getFilesToTrack(files);
+
+    if (res.isValid()) {
+        for (auto& file : files) {
+            PropsFile propsFile = PropsFile::make_file(file);
+            // Sets group (if available)
+            if (option_map.count(tracker_cmd::_GROUP_NAME_) != 0) {
+                propsFile.setGroup(option_map.at(tracker_cmd::_GROUP_NAME_));
+            }
+            propsFiles.push_back(propsFile);
+        }
+
+        if (!propsFiles.empty()) {
+            res = propsTracker_->add(propsFiles);
+            if (res.isValid()) {
+                res.setMessage("Now tracking " + std::to_string(propsFiles.size()) + " files");
+            }
+        } else {
+            res = Result{res::ERROR};
+            res.setMessage("No files found to track");
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Retrieves the files to track from the arguments, expanding
+ * glob patterns and (if recursive) directories. Directories
+ * are rejected unless recursive.
+ *
+ * @param files the files to track
+ * @return the result of the operation
+ */
+Result PropsTrackerCommand::getFilesToTrack(std::vector<std::string>& files) {
+    Result res{res::VALID};
+    const auto& option_map = optionStore_.getOptions();
+    const bool recursive = (option_map.count(tracker_cmd::_RECURSIVE_) != 0);
+    const std::string pattern = (option_map.count(tracker_cmd::_FILE_PATTERN_) != 0) ? option_map.at(tracker_cmd::_FILE_PATTERN_)
+                                                                                      : tracker_cmd::_DEFAULT_FILE_PATTERN_;
+    std::vector<std::string> directories;
+
     for (auto& file : optionStore_.getArgs()) {
-        PropsFile propsFile = PropsFile::make_file(file);
-        // Sets group (if available)
-        if (option_map.count(tracker_cmd::_GROUP_NAME_) != 0) {
-            propsFile.setGroup(option_map.at(tracker_cmd::_GROUP_NAME_));
+        std::vector<std::string> paths;
+
+        // Expand the patterns not expanded by the shell (i.e. quoted)
+        if ((file.find_first_of("*?[") == std::string::npos) || FileUtils::fileExists(file) || !FileUtils::expandPattern(file, paths)) {
+            paths.push_back(file);
+        }
+
+        for (auto& path : paths) {
+            if (!FileUtils::isDirectory(path)) {
+                files.push_back(path);
+            } else if (recursive) {
+                directories.push_back(path);
+            } else if (res.isValid()) {
+                res = Result{res::ERROR};
+                res.setMessage("\"" + path + "\" is a directory (use the recursive option to track its files)");
+            }
         }
-        propsFiles.push_back(propsFile);
     }
 
-    Result res = propsTracker_->add(propsFiles);
     if (res.isValid()) {
-        res.setMessage("Now tracking " + std::to_string(propsFiles.size()) + " files");
+        traverseDirectories(directories, pattern, files);
     }
 
     return res;
 }
 
+/**
+ * Retrieves the files matching the given pattern in the given
+ * directories and their subdirectories, listing the directories
+ * of every level in parallel.
+ *
+ * @param directories the directories to traverse
+ * @param pattern the glob pattern for the file names
+ * @param files the matching files found
+ */
+void PropsTrackerCommand::traverseDirectories(std::vector<std::string> directories, const std::string& pattern, std::vector<std::string>& files) {
+    ThreadPool& threadPool = ThreadPool::getDefault();
+
+    while (!directories.empty()) {
+        std::vector<std::vector<std::string>> levelFiles(directories.size());
+        std::vector<std::vector<std::string>> levelDirectories(directories.size());
+        std::vector<std::future<bool>> listed;
+
+        for (size_t i = 0; i < directories.size(); i++) {
+            const std::string* pDirectory = &directories[i];
+            std::vector<std::string>* pFiles = &levelFiles[i];
+            std::vector<std::string>* pDirectories = &levelDirectories[i];
+            listed.push_back(threadPool.submit([pDirectory, &pattern, pFiles, pDirectories]() {
+                bool read = FileUtils::listDirectory(*pDirectory, pattern, *pFiles, *pDirectories);
+                // Keep a stable order regardless of the file system
+                std::sort(pFiles->begin(), pFiles->end());
+                std::sort(pDirectories->begin(), pDirectories->end());
+                return read;
+            }));
+        }
+
+        std::vector<std::string> nextDirectories;
+        for (size_t i = 0; i < directories.size(); i++) {
+            if (!listed[i].get()) {
+                Result res{res::ERROR};
+                res.setSeverity(res::WARN);
+                res.setMessage("WARN: Cannot read directory \"" + directories[i] + "\"");
+                res.showMessage();
+            }
+            files.insert(files.end(), levelFiles[i].begin(), levelFiles[i].end());
+            nextDirectories.insert(nextDirectories.end(), levelDirectories[i].begin(), levelDirectories[i].end());
+        }
+
+        directories.swap(nextDirectories);
+    }
+}
+
 /**
  * Removes from the tracker the selected filed using the file
  * name or the alias (if set).
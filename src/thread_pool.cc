@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019 Pablo Navais
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "thread_pool.h"
+#include "props_config.h"
+
+/**
+ * Static holder for the singleton instance. The size of the
+ * pool defaults to the number of hardware threads.
+ *
+ * @return the singleton instance
+ */
+ThreadPool& ThreadPool::getDefault() {
+    static ThreadPool instance(PropsConfig::getDefault().getValue<size_t>(thread_pool::MAX_WORKER_THREADS, std::thread::hardware_concurrency()));
+    return instance;
+}
+
+/**
+ * Creates the pool starting the given number of threads.
+ *
+ * @param numThreads the number of threads
+ */
+ThreadPool::ThreadPool(const size_t& numThreads) : stopping_(false) {
+    size_t total = (numThreads > 0) ? numThreads : 1;
+    for (size_t i = 0; i < total; i++) {
+        threads_.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+/**
+ * Finishes the pending tasks and joins the threads.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+/**
+ * Executes the queued tasks until the pool is stopped.
+ */
+void ThreadPool::run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                break;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}